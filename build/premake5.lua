@@ -14,6 +14,27 @@ newoption
     default = "opengl33"
 }
 
+newoption
+{
+    trigger = "simd",
+    value = "ISA",
+    description = "instruction set for the solver's candidate kernel",
+    allowed = {
+        { "auto", "SSE4.1 on x86/x64, NEON on ARM64"},
+        { "sse4", "SSE4.1"},
+        { "avx2", "AVX2"},
+        { "neon", "NEON"},
+        { "none", "Scalar fallback"}
+    },
+    default = "auto"
+}
+
+newoption
+{
+    trigger = "stats",
+    description = "count solver work (nodes, backtracks, fill/dig time), F3 shows it in the game"
+}
+
 function download_progress(total, current)
     local ratio = current / total;
     ratio = math.min(math.max(ratio, 0), 1);
@@ -86,6 +107,33 @@ function platform_defines()
     filter{}
 end
 
+-- build flags of the solver core: candidate kernel (anything unsupported falls back to
+-- scalar code) and the optional stats counters
+function core_defines()
+    filter {"options:stats"}
+        defines{"SUDOKU_STATS"}
+
+    filter {"options:simd=auto", "platforms:x64 or x86"}
+        defines{"SUDOKU_SIMD_SSE4"}
+        vectorextensions "SSE4.1"
+
+    filter {"options:simd=auto", "platforms:ARM64"}
+        defines{"SUDOKU_SIMD_NEON"}
+
+    filter {"options:simd=sse4"}
+        defines{"SUDOKU_SIMD_SSE4"}
+        vectorextensions "SSE4.1"
+
+    filter {"options:simd=avx2"}
+        defines{"SUDOKU_SIMD_AVX2"}
+        vectorextensions "AVX2"
+
+    filter {"options:simd=neon"}
+        defines{"SUDOKU_SIMD_NEON"}
+
+    filter{}
+end
+
 -- if you don't want to download raylib, then set this to false, and set the raylib dir to where you want raylib to be pulled from, must be full sources.
 downloadRaylib = true
 raylib_dir = "external/raylib-master"
@@ -182,6 +230,7 @@ if (downloadRaylib) then
         includedirs { raylib_dir .."/src/external/glfw/include" }
         flags { "ShadowedVariables"}
         platform_defines()
+        core_defines()
 
         filter "action:vs*"
             defines{"_WINSOCK_DEPRECATED_NO_WARNINGS", "_CRT_SECURE_NO_WARNINGS"}
@@ -202,7 +251,94 @@ if (downloadRaylib) then
             links {"OpenGL.framework", "Cocoa.framework", "IOKit.framework", "CoreFoundation.framework", "CoreAudio.framework", "CoreVideo.framework", "AudioToolbox.framework"}
 
         filter{}
-        
+
+
+    -- headless generator, shares the solver core with the game but never links raylib
+    project "sudoku-cli"
+        kind "ConsoleApp"
+        location "build_files/"
+        targetdir "../bin/%{cfg.buildcfg}"
+
+        language "C"
+        cdialect "C17"
+
+        vpaths
+        {
+            ["Header Files/*"] = { "../src/**.h"},
+            ["Source Files/*"] = { "../src/sudoku_core.c", "../src/sudoku_geometry.c", "../src/platform_thread.c", "../tools/**.c"},
+        }
+        files {"../src/sudoku_core.c", "../src/sudoku_geometry.c", "../src/platform_thread.c", "../src/puzzle_corpus.c", "../src/puzzle_text.c", "../src/*.h", "../tools/sudoku_cli.c"}
+
+        includedirs { "../src" }
+        core_defines()
+
+        filter "action:vs*"
+            defines{"_CRT_SECURE_NO_WARNINGS"}
+
+        filter "system:linux"
+            links {"pthread", "m"}
+
+        filter{}
+
+
+    -- puzzle service: answers batched generate/verify requests over TCP (src/puzzle_service.h)
+    project "sudoku-daemon"
+        kind "ConsoleApp"
+        location "build_files/"
+        targetdir "../bin/%{cfg.buildcfg}"
+
+        language "C"
+        cdialect "C17"
+
+        vpaths
+        {
+            ["Header Files/*"] = { "../src/**.h"},
+            ["Source Files/*"] = { "../src/sudoku_core.c", "../src/platform_thread.c", "../src/puzzle_corpus.c", "../src/puzzle_pool.c", "../tools/**.c"},
+        }
+        files {"../src/sudoku_core.c", "../src/platform_thread.c", "../src/puzzle_corpus.c", "../src/puzzle_pool.c", "../src/*.h", "../tools/sudoku_daemon.c"}
+
+        includedirs { "../src" }
+        core_defines()
+
+        filter "action:vs*"
+            defines{"_CRT_SECURE_NO_WARNINGS"}
+
+        filter "system:windows"
+            links {"ws2_32"}
+
+        filter "system:linux"
+            links {"pthread", "m"}
+
+        filter{}
+
+
+    -- solver/generator benchmark with fixed seeds, prints one JSON line per benchmark
+    project "sudoku-bench"
+        kind "ConsoleApp"
+        location "build_files/"
+        targetdir "../bin/%{cfg.buildcfg}"
+
+        language "C"
+        cdialect "C17"
+
+        vpaths
+        {
+            ["Header Files/*"] = { "../src/**.h"},
+            ["Source Files/*"] = { "../src/sudoku_core.c", "../tools/**.c"},
+        }
+        files {"../src/sudoku_core.c", "../src/*.h", "../tools/sudoku_bench.c"}
+
+        includedirs { "../src" }
+        core_defines()
+
+        filter "action:vs*"
+            defines{"_CRT_SECURE_NO_WARNINGS"}
+
+        filter "system:linux"
+            links {"m"}
+
+        filter{}
+
 
     project "raylib"
         kind "StaticLib"
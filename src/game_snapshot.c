@@ -0,0 +1,130 @@
+#include "game_snapshot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void movelog_init(MoveLog *log) {
+  memset(log, 0, sizeof(*log));
+}
+
+void movelog_free(MoveLog *log) {
+  free(log->moves);
+  movelog_init(log);
+}
+
+void movelog_clear(MoveLog *log) {
+  log->count = 0;
+  log->position = 0;
+}
+
+// Capacity doubles, so pushes are amortized O(1)
+static bool movelog_reserve(MoveLog *log, int count) {
+  if (count <= log->capacity) {
+    return true;
+  }
+  int capacity = log->capacity > 0 ? log->capacity : 64;
+  while (capacity < count) {
+    capacity *= 2;
+  }
+  Move *moves = realloc(log->moves, (size_t)capacity * sizeof(Move));
+  if (moves == NULL) {
+    return false;
+  }
+  log->moves = moves;
+  log->capacity = capacity;
+  return true;
+}
+
+bool movelog_push(MoveLog *log, int cell, CellValue old_value, CellValue new_value) {
+  if (!movelog_reserve(log, log->position + 1)) {
+    return false;
+  }
+  log->moves[log->position].cell = (uint8_t)cell;
+  log->moves[log->position].values = (uint8_t)(old_value | (new_value << 4));
+  log->position++;
+  log->count = log->position;
+  return true;
+}
+
+bool movelog_undo(MoveLog *log, Move *move) {
+  if (log->position == 0) {
+    return false;
+  }
+  *move = log->moves[--log->position];
+  return true;
+}
+
+bool movelog_redo(MoveLog *log, Move *move) {
+  if (log->position == log->count) {
+    return false;
+  }
+  *move = log->moves[log->position++];
+  return true;
+}
+
+static void put_le(uint8_t *bytes, uint64_t value, int size) {
+  for (int b = 0; b < size; b++) {
+    bytes[b] = (uint8_t)(value >> (b * 8));
+  }
+}
+
+static uint64_t get_le(const uint8_t *bytes, int size) {
+  uint64_t value = 0;
+  for (int b = 0; b < size; b++) {
+    value |= (uint64_t)bytes[b] << (b * 8);
+  }
+  return value;
+}
+
+#define SNAPSHOT_HEADER_SIZE 24
+#define SNAPSHOT_MAX_MOVES (1 << 16) // anything longer is a damaged count
+
+bool snapshot_save(const char *path, const SnapshotInfo *info, const MoveLog *log) {
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) {
+    return false;
+  }
+  uint8_t header[SNAPSHOT_HEADER_SIZE];
+  memcpy(header, SNAPSHOT_MAGIC, 4);
+  header[4] = SNAPSHOT_VERSION;
+  header[5] = (uint8_t)info->difficulty;
+  header[6] = info->flags;
+  header[7] = info->mistakes;
+  put_le(header + 8, info->seed, 8);
+  put_le(header + 16, info->elapsed, 4);
+  put_le(header + 20, (uint32_t)log->position, 4);
+  fwrite(header, 1, sizeof(header), file);
+  if (log->position > 0) {
+    fwrite(log->moves, sizeof(Move), (size_t)log->position, file); // two bytes, no padding
+  }
+  return fclose(file) == 0;
+}
+
+bool snapshot_load(const char *path, SnapshotInfo *info, MoveLog *log) {
+  FILE *file = fopen(path, "rb");
+  if (file == NULL) {
+    return false;
+  }
+  uint8_t header[SNAPSHOT_HEADER_SIZE];
+  bool ok = fread(header, 1, sizeof(header), file) == sizeof(header) &&
+            memcmp(header, SNAPSHOT_MAGIC, 4) == 0 && header[4] == SNAPSHOT_VERSION &&
+            header[5] < DIFFICULTY_COUNT && (header[6] & ~CORPUS_FLAGS) == 0 && header[7] < SNAPSHOT_MISTAKE_LIMIT;
+  uint32_t count = ok ? (uint32_t)get_le(header + 20, 4) : 0;
+  ok = ok && count <= SNAPSHOT_MAX_MOVES && movelog_reserve(log, (int)count);
+  if (ok) {
+    info->difficulty = (Difficulty)header[5];
+    info->flags = header[6];
+    info->mistakes = header[7];
+    info->seed = get_le(header + 8, 8);
+    info->elapsed = (uint32_t)get_le(header + 16, 4);
+    ok = count == 0 || fread(log->moves, sizeof(Move), count, file) == count;
+  }
+  for (uint32_t n = 0; n < count && ok; n++) {
+    Move move = log->moves[n];
+    ok = move.cell < CELL_COUNT && move_old(move) <= V_9 && move_new(move) <= V_9;
+  }
+  log->count = log->position = ok ? (int)count : 0;
+  fclose(file);
+  return ok;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "puzzle_corpus.h"
+#include "sudoku_core.h"
+
+// Undo/redo log and save files for a game in progress. A game is its puzzle seed
+// (see corpus_generate()) plus the moves made on it, so a save is a few bytes per
+// move instead of two boards.
+
+// One board edit: the cell and its value before and after, so it can be replayed
+// in both directions without looking at the board
+typedef struct {
+  uint8_t cell;
+  uint8_t values;  // old value in the low nibble, new value in the high nibble
+} Move;
+
+static inline CellValue move_old(Move move) { return (CellValue)(move.values & 0xF); }
+static inline CellValue move_new(Move move) { return (CellValue)(move.values >> 4); }
+
+// moves[0..position) are applied, moves[position..count) can be redone
+typedef struct {
+  Move *moves;
+  int count;
+  int position;
+  int capacity;
+} MoveLog;
+
+void movelog_init(MoveLog *log);
+void movelog_free(MoveLog *log);
+void movelog_clear(MoveLog *log);
+// Records an applied edit and drops the redo tail; false if out of memory
+bool movelog_push(MoveLog *log, int cell, CellValue old_value, CellValue new_value);
+// Move to revert/reapply, false if there is none
+bool movelog_undo(MoveLog *log, Move *move);
+bool movelog_redo(MoveLog *log, Move *move);
+
+// Save file: "SDKS", version, difficulty, CORPUS_* flags, mistakes, the 8-byte seed,
+// elapsed seconds and the applied moves (redo tail dropped), little-endian
+#define SNAPSHOT_MAGIC "SDKS"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_MISTAKE_LIMIT 3 // the game is lost at this many, so no save can hold them
+
+typedef struct {
+  uint64_t seed;
+  Difficulty difficulty;
+  uint8_t flags;
+  uint8_t mistakes;
+  uint32_t elapsed;  // whole seconds played
+} SnapshotInfo;
+
+bool snapshot_save(const char *path, const SnapshotInfo *info, const MoveLog *log);
+// Replaces log with the saved moves; false if the file is missing or damaged
+bool snapshot_load(const char *path, SnapshotInfo *info, MoveLog *log);
@@ -0,0 +1,84 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L // sysconf() under -std=c17
+#endif
+
+#include "platform_thread.h"
+
+#if defined(_WIN32)
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+static DWORD WINAPI thread_trampoline(LPVOID param) {
+  Thread *thread = (Thread *)param;
+  thread->fn(thread->arg);
+  return 0;
+}
+
+bool thread_start(Thread *thread, ThreadFn fn, void *arg) {
+  thread->fn = fn;
+  thread->arg = arg;
+  thread->handle = CreateThread(NULL, 0, thread_trampoline, thread, 0, NULL);
+  return thread->handle != NULL;
+}
+
+void thread_join(Thread *thread) {
+  WaitForSingleObject((HANDLE)thread->handle, INFINITE);
+  CloseHandle((HANDLE)thread->handle);
+  thread->handle = NULL;
+}
+
+void mutex_init(Mutex *mutex) { InitializeSRWLock((PSRWLOCK)&mutex->lock); }
+void mutex_destroy(Mutex *mutex) { (void)mutex; } // SRW locks need no cleanup
+void mutex_lock(Mutex *mutex) { AcquireSRWLockExclusive((PSRWLOCK)&mutex->lock); }
+void mutex_unlock(Mutex *mutex) { ReleaseSRWLockExclusive((PSRWLOCK)&mutex->lock); }
+
+void cond_init(CondVar *cond) { InitializeConditionVariable((PCONDITION_VARIABLE)&cond->cond); }
+void cond_destroy(CondVar *cond) { (void)cond; }
+void cond_wait(CondVar *cond, Mutex *mutex) {
+  SleepConditionVariableSRW((PCONDITION_VARIABLE)&cond->cond, (PSRWLOCK)&mutex->lock, INFINITE, 0);
+}
+void cond_signal(CondVar *cond) { WakeConditionVariable((PCONDITION_VARIABLE)&cond->cond); }
+void cond_broadcast(CondVar *cond) { WakeAllConditionVariable((PCONDITION_VARIABLE)&cond->cond); }
+
+int cpu_count(void) {
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+}
+
+#else
+
+#include <unistd.h>
+
+static void *thread_trampoline(void *param) {
+  Thread *thread = (Thread *)param;
+  thread->fn(thread->arg);
+  return NULL;
+}
+
+bool thread_start(Thread *thread, ThreadFn fn, void *arg) {
+  thread->fn = fn;
+  thread->arg = arg;
+  return pthread_create(&thread->handle, NULL, thread_trampoline, thread) == 0;
+}
+
+void thread_join(Thread *thread) { pthread_join(thread->handle, NULL); }
+
+void mutex_init(Mutex *mutex) { pthread_mutex_init(&mutex->lock, NULL); }
+void mutex_destroy(Mutex *mutex) { pthread_mutex_destroy(&mutex->lock); }
+void mutex_lock(Mutex *mutex) { pthread_mutex_lock(&mutex->lock); }
+void mutex_unlock(Mutex *mutex) { pthread_mutex_unlock(&mutex->lock); }
+
+void cond_init(CondVar *cond) { pthread_cond_init(&cond->cond, NULL); }
+void cond_destroy(CondVar *cond) { pthread_cond_destroy(&cond->cond); }
+void cond_wait(CondVar *cond, Mutex *mutex) { pthread_cond_wait(&cond->cond, &mutex->lock); }
+void cond_signal(CondVar *cond) { pthread_cond_signal(&cond->cond); }
+void cond_broadcast(CondVar *cond) { pthread_cond_broadcast(&cond->cond); }
+
+int cpu_count(void) {
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? (int)n : 1;
+}
+
+#endif
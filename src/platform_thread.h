@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdbool.h>
+
+// Minimal threads/mutex/condition variable wrapper: pthreads on POSIX, Win32 on Windows
+// (C11 <threads.h> is missing on macOS and older MSVC). windows.h stays out of this
+// header so it can be included next to raylib.h.
+
+typedef void (*ThreadFn)(void *arg);
+
+#if defined(_WIN32)
+typedef struct { void *handle; ThreadFn fn; void *arg; } Thread;
+typedef struct { void *lock; } Mutex;   // SRWLOCK
+typedef struct { void *cond; } CondVar; // CONDITION_VARIABLE
+#else
+#include <pthread.h>
+typedef struct { pthread_t handle; ThreadFn fn; void *arg; } Thread;
+typedef struct { pthread_mutex_t lock; } Mutex;
+typedef struct { pthread_cond_t cond; } CondVar;
+#endif
+
+// The Thread struct must stay alive until thread_join()
+bool thread_start(Thread *thread, ThreadFn fn, void *arg);
+void thread_join(Thread *thread);
+
+void mutex_init(Mutex *mutex);
+void mutex_destroy(Mutex *mutex);
+void mutex_lock(Mutex *mutex);
+void mutex_unlock(Mutex *mutex);
+
+void cond_init(CondVar *cond);
+void cond_destroy(CondVar *cond);
+void cond_wait(CondVar *cond, Mutex *mutex);
+void cond_signal(CondVar *cond);
+void cond_broadcast(CondVar *cond);
+
+// Number of online logical CPUs (at least 1)
+int cpu_count(void);
@@ -0,0 +1,178 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L // mmap()/fstat() under -std=c17
+#endif
+
+#include "puzzle_corpus.h"
+
+#include <string.h>
+
+#if defined(_WIN32)
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+// Maps the whole file read-only, NULL on failure
+static const void *map_file(PuzzleCorpus *corpus, const char *path) {
+  HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    return NULL;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0 || (unsigned long long)size.QuadPart > SIZE_MAX) {
+    CloseHandle(file);
+    return NULL;
+  }
+  HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  const void *view = mapping != NULL ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+  if (view == NULL) {
+    if (mapping != NULL) {
+      CloseHandle(mapping);
+    }
+    CloseHandle(file);
+    return NULL;
+  }
+  corpus->file = file;
+  corpus->mapping = mapping;
+  corpus->size = (size_t)size.QuadPart;
+  return view;
+}
+
+static void unmap_file(PuzzleCorpus *corpus) {
+  UnmapViewOfFile(corpus->header);
+  CloseHandle((HANDLE)corpus->mapping);
+  CloseHandle((HANDLE)corpus->file);
+}
+
+#else
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const void *map_file(PuzzleCorpus *corpus, const char *path) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return NULL;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size == 0 || (unsigned long long)info.st_size > SIZE_MAX) {
+    close(fd);
+    return NULL;
+  }
+  void *view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd); // the mapping keeps the file alive
+  if (view == MAP_FAILED) {
+    return NULL;
+  }
+  corpus->file = NULL;
+  corpus->mapping = view;
+  corpus->size = (size_t)info.st_size;
+  return view;
+}
+
+static void unmap_file(PuzzleCorpus *corpus) {
+  munmap(corpus->mapping, corpus->size);
+}
+
+#endif
+
+// Only the header is checked: records are validated one at a time by corpus_record_unpack(),
+// so opening never touches more than the first page
+bool corpus_open(PuzzleCorpus *corpus, const char *path) {
+  memset(corpus, 0, sizeof(*corpus));
+  const void *view = map_file(corpus, path);
+  if (view == NULL) {
+    return false;
+  }
+  const CorpusHeader *header = (const CorpusHeader *)view;
+  bool ok = corpus->size >= sizeof(CorpusHeader) && memcmp(header->magic, CORPUS_MAGIC, 4) == 0 &&
+            header->version == CORPUS_VERSION && header->record_size == sizeof(CorpusRecord) &&
+            header->count <= (corpus->size - sizeof(CorpusHeader)) / sizeof(CorpusRecord);
+  for (int d = 0; d < DIFFICULTY_COUNT && ok; d++) {
+    const CorpusRange *range = &header->index[d];
+    ok = range->first <= header->count && range->count <= header->count - range->first;
+  }
+  corpus->header = header;
+  if (!ok) {
+    corpus_close(corpus);
+    return false;
+  }
+  corpus->records = (const CorpusRecord *)(header + 1);
+  return true;
+}
+
+void corpus_close(PuzzleCorpus *corpus) {
+  if (corpus->header != NULL) {
+    unmap_file(corpus);
+  }
+  memset(corpus, 0, sizeof(*corpus));
+}
+
+uint64_t corpus_count(const PuzzleCorpus *corpus, Difficulty difficulty) {
+  return corpus->header != NULL ? corpus->header->index[difficulty].count : 0;
+}
+
+// n must be below corpus_count()
+const CorpusRecord *corpus_get(const PuzzleCorpus *corpus, Difficulty difficulty, uint64_t n) {
+  return &corpus->records[corpus->header->index[difficulty].first + n];
+}
+
+void corpus_generate(uint64_t seed, Difficulty difficulty, unsigned int flags, PackedBoard *puzzle, PackedBoard *solution) {
+  GeneratorContext ctx;
+  generator_init(&ctx, seed);
+  ctx.symmetric = (flags & CORPUS_SYMMETRIC) != 0;
+  ctx.fill = (flags & CORPUS_TRANSFORM) ? FILL_TRANSFORM : FILL_BACKTRACK;
+  if (flags & CORPUS_RATED) {
+    RatedTarget target = {difficulty, 0, CORPUS_RATED_CANDIDATES};
+    PuzzleRating rating;
+    generate_rated(&ctx, &target, puzzle, solution, &rating);
+  } else {
+    generate_puzzle(&ctx, puzzle, solution, difficulty_cells_removed(difficulty));
+  }
+}
+
+void corpus_header_init(CorpusHeader *header, const uint64_t counts[DIFFICULTY_COUNT]) {
+  memset(header, 0, sizeof(*header));
+  memcpy(header->magic, CORPUS_MAGIC, 4);
+  header->version = CORPUS_VERSION;
+  header->record_size = sizeof(CorpusRecord);
+  for (int d = 0; d < DIFFICULTY_COUNT; d++) {
+    header->index[d].first = header->count;
+    header->index[d].count = counts[d];
+    header->count += counts[d];
+  }
+}
+
+void corpus_record_pack(CorpusRecord *record, const PackedBoard *puzzle, const PackedBoard *solution,
+                        uint64_t seed, Difficulty difficulty, Technique hardest, unsigned int flags) {
+  memset(record, 0, sizeof(*record));
+  record->seed = seed;
+  for (int i = 0; i < CELL_COUNT; i++) {
+    record->solution[i >> 1] |= (uint8_t)(solution->cells[i] << ((i & 1) * 4));
+    if (puzzle->cells[i] != V_None) {
+      record->clues[i >> 3] |= (uint8_t)(1u << (i & 7));
+      record->clue_count++;
+    }
+  }
+  record->difficulty = (uint8_t)difficulty;
+  record->hardest = (uint8_t)hardest;
+  record->flags = (uint8_t)flags;
+}
+
+bool corpus_record_unpack(const CorpusRecord *record, PackedBoard *puzzle, PackedBoard *solution) {
+  memset(puzzle, 0, sizeof(*puzzle));
+  memset(solution, 0, sizeof(*solution));
+  for (int i = 0; i < CELL_COUNT; i++) {
+    uint8_t value = (record->solution[i >> 1] >> ((i & 1) * 4)) & 0xF;
+    if (value < V_1 || value > V_9) {
+      return false;
+    }
+    solution->cells[i] = value;
+    if ((record->clues[i >> 3] >> (i & 7)) & 1) {
+      puzzle->cells[i] = value;
+      board_set_fixed(puzzle, i, true);
+    }
+  }
+  return board_solved(solution);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sudoku_core.h"
+
+// Binary puzzle corpus: a 64-byte header, then fixed 64-byte records sorted by
+// difficulty. Files are memory-mapped read-only, so opening one costs the same for
+// 10 puzzles or 10M, and every process using the same file shares its pages.
+// All integers are little-endian.
+
+#define CORPUS_MAGIC "SDKC"
+#define CORPUS_VERSION 2 // bumped whenever the seed -> puzzle mapping (rng.h) changes
+#define CORPUS_FILE_EXTENSION ".sdkc"
+
+// CorpusRecord flags: generator settings needed to regenerate the record from its seed
+#define CORPUS_SYMMETRIC 1u  // GeneratorContext.symmetric
+#define CORPUS_TRANSFORM 2u  // GeneratorContext.fill == FILL_TRANSFORM
+#define CORPUS_RATED 4u      // generate_rated() for the record's difficulty instead of generate_puzzle()
+#define CORPUS_FLAGS (CORPUS_SYMMETRIC | CORPUS_TRANSFORM | CORPUS_RATED) // every known flag
+#define CORPUS_RATED_CANDIDATES 100 // CORPUS_RATED candidate cap, a count rather than a time so it is reproducible
+
+typedef struct {
+  uint64_t first;  // index of the first record of this difficulty
+  uint64_t count;
+} CorpusRange;
+
+typedef struct {
+  char magic[4];        // CORPUS_MAGIC
+  uint16_t version;     // CORPUS_VERSION
+  uint16_t record_size; // sizeof(CorpusRecord)
+  uint64_t count;       // records in the file
+  CorpusRange index[DIFFICULTY_COUNT];
+} CorpusHeader;
+
+typedef struct {
+  uint64_t seed;                        // generator_init() seed the puzzle came from
+  uint8_t solution[(CELL_COUNT + 1) / 2]; // two cells per byte, low nibble first
+  uint8_t clues[(CELL_COUNT + 7) / 8];  // bit i set = cell i is a clue
+  uint8_t difficulty;                   // Difficulty it was generated for
+  uint8_t hardest;                      // Technique from rate_puzzle()
+  uint8_t clue_count;
+  uint8_t flags;                        // CORPUS_* settings, see CORPUS_FLAGS
+} CorpusRecord;
+
+_Static_assert(sizeof(CorpusHeader) == 64, "CorpusHeader must stay 64 bytes");
+_Static_assert(sizeof(CorpusRecord) == 64, "CorpusRecord must stay 64 bytes");
+
+// An open corpus; header and records point straight into the mapping
+typedef struct {
+  const CorpusHeader *header;
+  const CorpusRecord *records;
+  size_t size;       // bytes mapped
+  void *file;        // platform handles, see puzzle_corpus.c
+  void *mapping;
+} PuzzleCorpus;
+
+// False if the file is missing, truncated or not a corpus of this version
+bool corpus_open(PuzzleCorpus *corpus, const char *path);
+void corpus_close(PuzzleCorpus *corpus);
+
+uint64_t corpus_count(const PuzzleCorpus *corpus, Difficulty difficulty);
+const CorpusRecord *corpus_get(const PuzzleCorpus *corpus, Difficulty difficulty, uint64_t n);
+
+// The puzzle a seed stands for: generator_init(seed) with the CORPUS_* settings, then one
+// generate_puzzle() (or generate_rated()) for the difficulty. Everything that stores
+// puzzles as seeds (corpora, sudoku-cli, the pool, game snapshots) goes through this.
+void corpus_generate(uint64_t seed, Difficulty difficulty, unsigned int flags, PackedBoard *puzzle, PackedBoard *solution);
+
+// Writing side: counts are known before the first record, so the header goes first
+// and a corpus can be streamed to stdout
+void corpus_header_init(CorpusHeader *header, const uint64_t counts[DIFFICULTY_COUNT]);
+void corpus_record_pack(CorpusRecord *record, const PackedBoard *puzzle, const PackedBoard *solution,
+                        uint64_t seed, Difficulty difficulty, Technique hardest, unsigned int flags);
+// False if the record's solution is not a valid solved grid (a value outside 1..9, or
+// one repeated in a row, column or box)
+bool corpus_record_unpack(const CorpusRecord *record, PackedBoard *puzzle, PackedBoard *solution);
@@ -0,0 +1,252 @@
+#include "puzzle_pool.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// Cache file: "SDKP" + version byte, then per difficulty a count byte followed
+// by that many entries of 81 puzzle cells, 81 solution cells, the 8-byte seed
+// (little-endian) and the flags byte
+#define POOL_FILE_MAGIC "SDKP"
+#define POOL_FILE_VERSION 2
+
+void pool_init(PuzzlePool *pool, uint64_t seed) {
+  memset(pool, 0, sizeof(*pool));
+  generator_init(&pool->ctx, seed);
+  for (int d = 0; d < DIFFICULTY_COUNT; d++) {
+    pool->rings[d].refilling = true;
+  }
+  mutex_init(&pool->lock);
+  cond_init(&pool->refill);
+}
+
+static bool pool_from_corpus(const PuzzlePool *pool, int difficulty) {
+  return pool->corpus != NULL && corpus_count(pool->corpus, (Difficulty)difficulty) > 0;
+}
+
+// Ring the producer should fill next, -1 if none (call with the lock held)
+static int pool_next_ring(const PuzzlePool *pool) {
+  int best = -1;
+  for (int d = 0; d < DIFFICULTY_COUNT; d++) {
+    const PoolRing *ring = &pool->rings[d];
+    if (!ring->refilling) {
+      continue;
+    }
+    if (ring->wanted) {
+      return d; // somebody is waiting on this one
+    }
+    if (pool_from_corpus(pool, d)) {
+      continue; // only generated when the corpus let a pop down
+    }
+    if (best < 0 || ring->count < pool->rings[best].count) {
+      best = d;
+    }
+  }
+  return best;
+}
+
+static void pool_push(PoolRing *ring, const PoolEntry *entry) {
+  ring->entries[(ring->head + ring->count) % POOL_CAPACITY] = *entry;
+  ring->count++;
+  ring->wanted = false;
+  if (ring->count == POOL_CAPACITY) {
+    ring->refilling = false;
+  }
+}
+
+static void pool_producer_main(void *arg) {
+  PuzzlePool *pool = (PuzzlePool *)arg;
+  mutex_lock(&pool->lock);
+  for (;;) {
+    int d;
+    while (!pool->quit && (d = pool_next_ring(pool)) < 0) {
+      cond_wait(&pool->refill, &pool->lock);
+    }
+    if (pool->quit) {
+      break;
+    }
+    mutex_unlock(&pool->lock);
+
+    // every puzzle from its own seed, so a saved game only needs to store the seed;
+    // same steps as corpus_generate() with no flags, kept inline for ctx.stats
+    PoolEntry entry;
+    entry.seed = rng_next64(&pool->ctx.rng);
+    entry.flags = 0;
+    GeneratorContext ctx;
+    generator_init(&ctx, entry.seed);
+    ctx.strategy = pool->ctx.strategy;
+    generate_puzzle(&ctx, &entry.puzzle, &entry.solution, difficulty_cells_removed((Difficulty)d));
+    entry.stats = ctx.stats;
+
+    mutex_lock(&pool->lock);
+    pool_push(&pool->rings[d], &entry);
+  }
+  mutex_unlock(&pool->lock);
+}
+
+bool pool_start(PuzzlePool *pool) {
+  pool->quit = false;
+  pool->running = thread_start(&pool->producer, pool_producer_main, pool);
+  return pool->running;
+}
+
+void pool_stop(PuzzlePool *pool) {
+  if (pool->running) {
+    mutex_lock(&pool->lock);
+    pool->quit = true;
+    cond_signal(&pool->refill);
+    mutex_unlock(&pool->lock);
+    thread_join(&pool->producer);
+    pool->running = false;
+  }
+}
+
+void pool_destroy(PuzzlePool *pool) {
+  pool_stop(pool);
+  cond_destroy(&pool->refill);
+  mutex_destroy(&pool->lock);
+}
+
+void pool_attach_corpus(PuzzlePool *pool, const PuzzleCorpus *corpus) {
+  pool->corpus = corpus;
+  for (int d = 0; d < DIFFICULTY_COUNT; d++) {
+    uint64_t count = corpus_count(corpus, (Difficulty)d);
+    pool->corpus_next[d] = count > 0 ? rng_next64(&pool->ctx.rng) % count : 0;
+  }
+}
+
+// Next corpus record of a difficulty, skipping corrupt ones (call with the lock held)
+static bool pool_pop_corpus(PuzzlePool *pool, Difficulty difficulty, PoolEntry *out) {
+  uint64_t count = corpus_count(pool->corpus, difficulty);
+  for (uint64_t tries = 0; tries < count; tries++) {
+    const CorpusRecord *record = corpus_get(pool->corpus, difficulty, pool->corpus_next[difficulty]);
+    pool->corpus_next[difficulty] = (pool->corpus_next[difficulty] + 1) % count;
+    if (corpus_record_unpack(record, &out->puzzle, &out->solution)) {
+      memset(&out->stats, 0, sizeof(out->stats));
+      out->seed = record->seed;
+      out->flags = record->flags;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool pool_pop(PuzzlePool *pool, Difficulty difficulty, PoolEntry *out) {
+  bool popped = false;
+  mutex_lock(&pool->lock);
+  if (pool_from_corpus(pool, difficulty) && pool_pop_corpus(pool, difficulty, out)) {
+    mutex_unlock(&pool->lock);
+    return true;
+  }
+  PoolRing *ring = &pool->rings[difficulty];
+  if (ring->count > 0) {
+    *out = ring->entries[ring->head];
+    ring->head = (ring->head + 1) % POOL_CAPACITY;
+    ring->count--;
+    popped = true;
+  } else {
+    ring->wanted = true;
+  }
+  if (ring->count < POOL_LOW_WATER) {
+    ring->refilling = true;
+  }
+  if (ring->refilling) {
+    cond_signal(&pool->refill);
+  }
+  mutex_unlock(&pool->lock);
+  return popped;
+}
+
+int pool_count(PuzzlePool *pool, Difficulty difficulty) {
+  mutex_lock(&pool->lock);
+  int count = pool->rings[difficulty].count;
+  mutex_unlock(&pool->lock);
+  return count;
+}
+
+// Cheap sanity check for cache entries: complete valid solution, clues match it
+static bool pool_entry_valid(const PoolEntry *entry) {
+  if (!board_solved(&entry->solution)) {
+    return false;
+  }
+  for (int i = 0; i < CELL_COUNT; i++) {
+    if (entry->puzzle.cells[i] != V_None && entry->puzzle.cells[i] != entry->solution.cells[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int pool_load(PuzzlePool *pool, const char *path) {
+  FILE *file = fopen(path, "rb");
+  if (file == NULL) {
+    return 0; // no cache yet
+  }
+
+  int loaded = 0;
+  char magic[4];
+  bool ok = fread(magic, 1, 4, file) == 4 && memcmp(magic, POOL_FILE_MAGIC, 4) == 0 &&
+            fgetc(file) == POOL_FILE_VERSION;
+  mutex_lock(&pool->lock);
+  for (int d = 0; d < DIFFICULTY_COUNT && ok; d++) {
+    int count = fgetc(file);
+    ok = count != EOF;
+    for (int n = 0; n < count && ok; n++) {
+      PoolEntry entry;
+      memset(&entry, 0, sizeof(entry));
+      uint8_t tail[9];
+      ok = fread(entry.puzzle.cells, 1, CELL_COUNT, file) == CELL_COUNT &&
+           fread(entry.solution.cells, 1, CELL_COUNT, file) == CELL_COUNT &&
+           fread(tail, 1, sizeof(tail), file) == sizeof(tail);
+      if (!ok) {
+        break; // truncated file: keep what we have
+      }
+      PoolRing *ring = &pool->rings[d];
+      if (!pool_entry_valid(&entry) || ring->count == POOL_CAPACITY) {
+        continue;
+      }
+      for (int i = 0; i < CELL_COUNT; i++) {
+        board_set_fixed(&entry.puzzle, i, entry.puzzle.cells[i] != V_None);
+      }
+      for (int b = 0; b < 8; b++) {
+        entry.seed |= (uint64_t)tail[b] << (b * 8);
+      }
+      entry.flags = tail[8];
+      pool_push(ring, &entry);
+      loaded++;
+    }
+  }
+  for (int d = 0; d < DIFFICULTY_COUNT; d++) {
+    // a partially loaded ring still needs topping up
+    pool->rings[d].refilling = pool->rings[d].count < POOL_CAPACITY;
+  }
+  mutex_unlock(&pool->lock);
+  fclose(file);
+  return loaded;
+}
+
+bool pool_save(PuzzlePool *pool, const char *path) {
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) {
+    return false;
+  }
+  fwrite(POOL_FILE_MAGIC, 1, 4, file);
+  fputc(POOL_FILE_VERSION, file);
+  mutex_lock(&pool->lock);
+  for (int d = 0; d < DIFFICULTY_COUNT; d++) {
+    const PoolRing *ring = &pool->rings[d];
+    fputc(ring->count, file);
+    for (int n = 0; n < ring->count; n++) {
+      const PoolEntry *entry = &ring->entries[(ring->head + n) % POOL_CAPACITY];
+      fwrite(entry->puzzle.cells, 1, CELL_COUNT, file);
+      fwrite(entry->solution.cells, 1, CELL_COUNT, file);
+      uint8_t tail[9];
+      for (int b = 0; b < 8; b++) {
+        tail[b] = (uint8_t)(entry->seed >> (b * 8));
+      }
+      tail[8] = entry->flags;
+      fwrite(tail, 1, sizeof(tail), file);
+    }
+  }
+  mutex_unlock(&pool->lock);
+  return fclose(file) == 0;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "platform_thread.h"
+#include "puzzle_corpus.h"
+#include "sudoku_core.h"
+
+// Ready-made puzzles per difficulty, topped up by a background producer thread,
+// so taking one is an O(1) ring buffer pop instead of a generate_puzzle() call
+
+#define POOL_CAPACITY 16  // puzzles kept per difficulty
+#define POOL_LOW_WATER 4  // refill starts when a ring drops below this
+
+typedef struct {
+  PackedBoard puzzle;
+  PackedBoard solution;
+  SolverStats stats;  // what generating it took; zero when loaded from disk or without SUDOKU_STATS
+  uint64_t seed;      // corpus_generate() with seed and flags rebuilds the puzzle
+  uint8_t flags;      // CORPUS_* settings
+} PoolEntry;
+
+typedef struct {
+  PoolEntry entries[POOL_CAPACITY];
+  int head;        // oldest entry
+  int count;
+  bool refilling;  // set below the low-water mark, cleared once full again
+  bool wanted;     // a pop found it empty: generate for this ring first
+} PoolRing;
+
+typedef struct {
+  PoolRing rings[DIFFICULTY_COUNT];
+  GeneratorContext ctx;  // only used by the producer thread once it runs; its rng picks the puzzle seeds
+  Mutex lock;
+  CondVar refill;        // wakes the producer
+  Thread producer;
+  bool running;
+  bool quit;
+  const PuzzleCorpus *corpus;           // if set, difficulties it covers are served from it
+  uint64_t corpus_next[DIFFICULTY_COUNT]; // next record handed out per difficulty
+} PuzzlePool;
+
+void pool_init(PuzzlePool *pool, uint64_t seed);
+bool pool_start(PuzzlePool *pool); // starts the producer thread
+void pool_stop(PuzzlePool *pool);  // joins the producer (after its current puzzle)
+void pool_destroy(PuzzlePool *pool);
+
+// Takes the oldest puzzle of a difficulty, false if that ring is empty right now
+bool pool_pop(PuzzlePool *pool, Difficulty difficulty, PoolEntry *out);
+int pool_count(PuzzlePool *pool, Difficulty difficulty);
+
+// Serves pops from a mapped corpus instead of generating, for every difficulty it has
+// records of; starting at a random record, cycling through them. The corpus must stay
+// open until pool_destroy(). Attach before pool_start().
+void pool_attach_corpus(PuzzlePool *pool, const PuzzleCorpus *corpus);
+
+// On-disk cache so the next start is warm; load before pool_start()
+int pool_load(PuzzlePool *pool, const char *path); // returns puzzles loaded
+bool pool_save(PuzzlePool *pool, const char *path);
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "puzzle_corpus.h"
+
+// Wire format of sudoku-daemon (tools/sudoku_daemon.c), for frontends talking to it over
+// TCP. Every message, either way, is a ServiceHeader followed by count fixed-size records.
+// Requests on one connection are answered in order; the id is echoed so clients can
+// pipeline. An error reply (flags != SERVICE_OK) closes the connection. Little-endian.
+
+#define SERVICE_MAGIC "SDKQ"
+#define SERVICE_VERSION 1
+#define SERVICE_DEFAULT_PORT 7419
+#define SERVICE_MAX_COUNT 4096 // records per request, more gets SERVICE_TOO_LARGE
+
+typedef enum {
+  SERVICE_GENERATE = 1, // count puzzles of a difficulty, reply: count CorpusRecords
+  SERVICE_VERIFY = 2,   // count boards of CELL_COUNT bytes (0 = empty), reply: count ServiceVerifyRecords
+} ServiceType;
+
+typedef enum {
+  SERVICE_OK = 0,
+  SERVICE_BAD_REQUEST,  // wrong magic/version, unknown type or difficulty
+  SERVICE_TOO_LARGE,    // count above SERVICE_MAX_COUNT
+  SERVICE_FAILED,       // out of memory on the server
+} ServiceStatus;
+
+typedef struct {
+  char magic[4];       // SERVICE_MAGIC
+  uint8_t version;     // SERVICE_VERSION
+  uint8_t type;        // ServiceType, echoed in the reply
+  uint8_t difficulty;  // SERVICE_GENERATE: Difficulty
+  uint8_t flags;       // SERVICE_GENERATE request: CORPUS_* settings, 0 = any (served from the pool); reply: ServiceStatus
+  uint32_t count;      // records following the header
+  uint32_t id;         // the client's, echoed
+} ServiceHeader;
+
+// Same order as sudoku-cli --verify
+typedef enum {
+  SERVICE_UNIQUE = 0,
+  SERVICE_MULTIPLE,
+  SERVICE_NONE,
+  SERVICE_INVALID,     // a value above 9, or one repeated in a row, column or box
+} ServiceVerifyStatus;
+
+typedef struct {
+  uint8_t status;                         // ServiceVerifyStatus
+  uint8_t hardest;                        // Technique from rate_puzzle(), SERVICE_UNIQUE only
+  uint8_t difficulty;                     // rating_difficulty() of that, SERVICE_UNIQUE only
+  uint8_t clue_count;
+  uint8_t solution[(CELL_COUNT + 1) / 2]; // SERVICE_UNIQUE only, packed like CorpusRecord.solution
+  uint8_t reserved[3];
+} ServiceVerifyRecord;
+
+_Static_assert(sizeof(ServiceHeader) == 16, "ServiceHeader must stay 16 bytes");
+_Static_assert(sizeof(ServiceVerifyRecord) == 48, "ServiceVerifyRecord must stay 48 bytes");
@@ -0,0 +1,85 @@
+#include "puzzle_text.h"
+
+#include <string.h>
+
+void text_reader_init(TextReader *reader, FILE *file, char *buffer, size_t capacity) {
+  memset(reader, 0, sizeof(*reader));
+  reader->file = file;
+  reader->buffer = buffer;
+  reader->capacity = capacity;
+}
+
+// Cuts the line at buffer[start..end), "\r\n" endings included
+static const char *text_reader_take(TextReader *reader, size_t end, size_t next, size_t *length) {
+  const char *line = reader->buffer + reader->start;
+  size_t n = end - reader->start;
+  if (n > 0 && line[n - 1] == '\r') {
+    n--;
+  }
+  reader->start = next;
+  reader->line++;
+  *length = n;
+  return line;
+}
+
+const char *text_reader_line(TextReader *reader, size_t *length) {
+  for (;;) {
+    char *newline = memchr(reader->buffer + reader->start, '\n', reader->end - reader->start);
+    if (newline != NULL) {
+      size_t end = (size_t)(newline - reader->buffer);
+      if (reader->skipping) {
+        reader->skipping = false;
+        reader->start = end + 1;
+        continue;
+      }
+      return text_reader_take(reader, end, end + 1, length);
+    }
+    if (reader->eof) {
+      if (reader->start == reader->end || reader->skipping) {
+        reader->start = reader->end;
+        return NULL;
+      }
+      return text_reader_take(reader, reader->end, reader->end, length); // no final newline
+    }
+
+    // keep the partial line, refill behind it
+    memmove(reader->buffer, reader->buffer + reader->start, reader->end - reader->start);
+    reader->end -= reader->start;
+    reader->start = 0;
+    if (reader->end == reader->capacity) {
+      if (reader->skipping) {
+        reader->end = 0;
+      } else {
+        reader->skipping = true; // hand out what fits, drop the rest
+        return text_reader_take(reader, reader->end, reader->end, length);
+      }
+    }
+    size_t got = fread(reader->buffer + reader->end, 1, reader->capacity - reader->end, reader->file);
+    reader->end += got;
+    reader->eof = got == 0;
+  }
+}
+
+bool puzzle_text_parse(const char *text, size_t length, PackedBoard *board) {
+  if (length < PUZZLE_TEXT_LENGTH) {
+    return false;
+  }
+  memset(board, 0, sizeof(*board));
+  for (int i = 0; i < CELL_COUNT; i++) {
+    char c = text[i];
+    if (c >= '1' && c <= '9') {
+      board->cells[i] = (uint8_t)(c - '0');
+      board_set_fixed(board, i, true);
+    } else if (c != '.' && c != '0') {
+      return false;
+    }
+  }
+  return true;
+}
+
+char *puzzle_text_format(char *text, const PackedBoard *board) {
+  for (int i = 0; i < CELL_COUNT; i++) {
+    text[i] = board->cells[i] == V_None ? '.' : (char)('0' + board->cells[i]);
+  }
+  return text + CELL_COUNT;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "sudoku_core.h"
+
+// The usual exchange format: one puzzle per line, 81 chars row-major, '.' or '0' for
+// empty cells. Anything after the 81st char (e.g. ",solution") is ignored.
+// board_to_sudoku()/board_from_sudoku() convert to and from the front end's Sudoku.
+
+#define PUZZLE_TEXT_LENGTH CELL_COUNT
+
+// Streaming line reader over a caller-owned buffer: files of any size are read in
+// buffer-sized chunks with no allocation per line
+typedef struct {
+  FILE *file;
+  char *buffer;
+  size_t capacity;
+  size_t start, end;  // unread bytes are buffer[start..end)
+  bool eof;
+  bool skipping;      // rest of an overlong line still to be dropped
+  long line;          // lines returned so far
+} TextReader;
+
+void text_reader_init(TextReader *reader, FILE *file, char *buffer, size_t capacity);
+// Next line without its "\n" or "\r\n", NULL at the end of the input. The text points
+// into the buffer and stays valid until the next call. Lines longer than the buffer
+// are cut at the buffer size.
+const char *text_reader_line(TextReader *reader, size_t *length);
+
+// False if the line is shorter than 81 chars or holds anything but '1'..'9', '.', '0'
+bool puzzle_text_parse(const char *text, size_t length, PackedBoard *board);
+// Writes 81 chars ('.' for empty, no terminator), returns the end
+char *puzzle_text_format(char *text, const PackedBoard *board);
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+
+// PCG32 (XSH RR, 64-bit state): small, fast and statistically solid. Every context or
+// thread owns its own state; nothing here is global or seeded from the clock.
+//
+// Seed -> puzzle mapping: generator_init(seed) followed by one generate_puzzle() with
+// the same GeneratorContext settings and cell count always gives the same puzzle, on
+// every platform and build (the generator only draws through rng_below()). That is why
+// a puzzle can be stored as its 8-byte seed. Changing this file changes that mapping,
+// so bump CORPUS_VERSION along with it.
+typedef struct {
+  uint64_t state;
+  uint64_t inc;  // stream selector, always odd
+} Rng;
+
+#define RNG_MULTIPLIER 6364136223846793005ull
+#define RNG_STREAM 0xDA3E39CB94B95BDBull
+
+static inline uint32_t rng_next(Rng *rng) {
+  uint64_t old = rng->state;
+  rng->state = old * RNG_MULTIPLIER + rng->inc;
+  uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+  uint32_t rot = (uint32_t)(old >> 59);
+  return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+// Seed goes through splitmix64 first so that nearby seeds start far apart
+static inline void rng_seed(Rng *rng, uint64_t seed) {
+  uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  z ^= z >> 31;
+  rng->state = 0;
+  rng->inc = (RNG_STREAM << 1) | 1u;
+  rng_next(rng);
+  rng->state += z;
+  rng_next(rng);
+}
+
+// Random int in [0, n), unbiased (Lemire's multiply-shift with rejection)
+static inline int rng_below(Rng *rng, int n) {
+  uint32_t bound = (uint32_t)n;
+  uint64_t m = (uint64_t)rng_next(rng) * bound;
+  if ((uint32_t)m < bound) {
+    uint32_t threshold = (0u - bound) % bound;
+    while ((uint32_t)m < threshold) {
+      m = (uint64_t)rng_next(rng) * bound;
+    }
+  }
+  return (int)(m >> 32);
+}
+
+static inline uint64_t rng_next64(Rng *rng) {
+  uint64_t high = rng_next(rng);
+  return (high << 32) | rng_next(rng);
+}
@@ -2,46 +2,27 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
-#include <time.h> // For seeding rand()
-#include <string.h> // For memcpy
+#include <string.h>
+#include <time.h> // For seeding the generator
+
+#include "game_snapshot.h"
+#include "puzzle_pool.h"
+#include "sudoku_core.h"
 
 // --- Config/DRAWING BOARD ---
 #define windowWidth 900
 #define windowHeight 900
-#define ROWS 9
-#define COLS 9
 #define cellWidth (windowWidth / COLS)
 #define cellHeight (windowHeight / ROWS)
-
-// Difficulty settings 
-#define EASY_CELLS_REMOVED 35
-#define MEDIUM_CELLS_REMOVED 45
-#define HARD_CELLS_REMOVED 55
-
-// --- Types ---
-typedef enum {
-  V_None = 0, // empty cell
-  V_1, V_2, V_3, V_4, V_5, V_6, V_7, V_8, V_9
-} CellValue;
-
-typedef enum {
-  FIXED = 0, // OG puzzle cell (cannot be changed by user)
-  DYNAMIC    // userinput cell (can be changed)
-} CellType;
-
-typedef struct {
-  CellValue value;
-  CellType type;
-} Cell;
-
-typedef struct {
-  size_t rows, cols;
-  Cell *grid; // dynamic array for the grid
-} Sudoku;
+#define POOL_CACHE_FILE "sudoku_pool.bin" // ready puzzles saved at exit, loaded at start
+#define CORPUS_FILE "puzzles.sdkc"        // optional sudoku-cli --binary corpus, mapped at start
+#define SAVE_FILE "sudoku_save.bin"       // game left unfinished at exit, offered on the menu
+#define IDLE_POLL_INTERVAL (1.0 / 60.0)   // input polling while idle in timed states
 
 // --- Game States ---
 typedef enum {
   STATE_MENU,
+  STATE_GENERATING, // waiting for the pool to have a puzzle
   STATE_PLAYING,
   STATE_WIN,
   STATE_LOSE
@@ -50,214 +31,195 @@ typedef enum {
 // --- Globals ---
 int selectedRow = -1, selectedCol = -1; // -1 = no cell selected
 GameState gameState = STATE_MENU;
-int selectedDifficulty = 0; // number of cells to remove
+Difficulty selectedDifficulty = DIFFICULTY_EASY;
 double startTime = 0;
 double elapsed = 0;
 int mistakeCount = 0;
 int score = 0;
+int emptyCells = 0; // DYNAMIC cells still empty, the game is won at 0
 
 Sudoku current_puzzle_grid;
 Sudoku solution_grid;
+PuzzlePool puzzle_pool; // ready puzzles per difficulty, refilled in the background
+PuzzleCorpus puzzle_corpus; // mapped corpus, header NULL when there is none
+SolverStats game_stats; // generation work behind the current puzzle
+
+// Undo/redo and save/resume: the current puzzle is known by its seed, edits go to moveLog
+MoveLog moveLog;
+uint64_t gameSeed = 0;
+uint8_t gameFlags = 0;  // CORPUS_* settings the seed was generated with
+SnapshotInfo savedInfo; // save file found at start, valid while savedGame is set
+MoveLog savedMoves;
+bool savedGame = false;
+bool resumedGame = false; // the save file has been taken over by this session
+
+// Render cache: grid lines and FIXED clues only change with the puzzle, so they are
+// drawn once into boardLayer and blitted every frame
+#define DIGIT_FONT_SIZE 30
+RenderTexture2D boardLayer;
+bool boardLayerDirty = true;
+Vector2 digitSize[10]; // measured glyph size of "1".."9", index = value
+static const char *digitText[10] = {"", "1", "2", "3", "4", "5", "6", "7", "8", "9"};
+bool showStats = false; // F3 debug overlay, SUDOKU_STATS builds only
+
+// Pencil marks: candidates come from playHints, updated per move, and are drawn into
+// their own layer one cell at a time, only for the cells whose candidates changed
+#define PENCIL_FONT_SIZE 20
+PlayHints playHints;
+RenderTexture2D pencilLayer;
+bool showCandidates = false; // C toggles
+Vector2 pencilSize[10];
+HintMove shownHint = {-1, V_None, TECHNIQUE_GUESS}; // last H press, cell -1 = none shown
+bool hintShown = false;
+
+// HUD line cached with its measured width, rebuilt only when its value changes
+typedef struct {
+  char text[64];
+  int width;
+  int value;
+  bool valid;
+} HudText;
 
-// --- Sudoku Functions ---
+HudText hudMistakes, hudTime, hudScore;
 
-// Initializes a new Sudoku grid by allocating memory
-Sudoku game_open(size_t rows, size_t cols) {
-  Sudoku newSudokuGrid = {rows, cols, calloc(rows * cols, sizeof(Cell))};
-  if (newSudokuGrid.grid == NULL) {
-    // allocation error gracefully
-    fprintf(stderr, "Error: Failed to allocate memory\n");
-    exit(EXIT_FAILURE); 
-  }
-  return newSudokuGrid;
-}
+// Startup: the menu needs none of the pool, corpus, save file or render cache, so they
+// load right after the first frame is on screen instead of before it
+bool startupPending = true;
+double firstFrameTime = -1; // GetTime() right after the first EndDrawing()
 
-// Frees the memory/avoid leaks
-void game_close(Sudoku sudoku_instance) {
-  if (sudoku_instance.grid != NULL) {
-    free(sudoku_instance.grid);
-    sudoku_instance.grid = NULL; 
-  }
-}
+// Redraw scheduling: a frame is only drawn when something on screen can have changed
+int drawnState = -1;      // gameState of the last drawn frame, -1 = nothing drawn yet
+int drawnSecond = -1;     // HUD clock second of the last drawn frame
 
-// Fills all the grid with a specified value and sets all cell types 
-void grid_fill(Sudoku sudoku_instance, CellValue val, CellType type) {
-  for (size_t i = 0; i < sudoku_instance.rows * sudoku_instance.cols; i++) {
-    sudoku_instance.grid[i].value = val;
-    sudoku_instance.grid[i].type = type;
-  }
-}
+// --- Sudoku Game ---
 
-// Checks if a value is valid at a given (Sudoku rules)
-bool is_valid(Sudoku sudoku_instance, int row, int col, CellValue val) {
-  // Check row
-  for (int x = 0; x < sudoku_instance.cols; x++) {
-    if (x != col && sudoku_instance.grid[row * sudoku_instance.cols + x].value == val) {
-      return false;
-    }
+// Installs a finished puzzle as the current game and starts the clock
+// Both grids are allocated on the first call only, later games reuse them
+void start_game(const PoolEntry *entry) {
+  if (solution_grid.grid == NULL) {
+    solution_grid = game_open(ROWS, COLS);
   }
-
-  // Check column
-  for (int y = 0; y < sudoku_instance.rows; y++) {
-    if (y != row && sudoku_instance.grid[y * sudoku_instance.cols + col].value == val) {
-      return false;
-    }
+  if (current_puzzle_grid.grid == NULL) {
+    current_puzzle_grid = game_open(ROWS, COLS);
   }
 
-  // Check 3x3 box
-  int boxRow = (row / 3) * 3;
-  int boxCol = (col / 3) * 3;
-  for (int r = 0; r < 3; r++) {
-    for (int c = 0; c < 3; c++) {
-      int i = (boxRow + r) * sudoku_instance.cols + (boxCol + c);
-        if ((boxRow + r != row || boxCol + c != col) && sudoku_instance.grid[i].value == val) {
-          return false;
-        }
-    }
+  // Unpack both into the Cell grids the front end works with
+  board_to_sudoku(&solution_grid, &entry->solution);
+  board_to_sudoku(&current_puzzle_grid, &entry->puzzle);
+  emptyCells = 0;
+  for (int i = 0; i < ROWS * COLS; i++) {
+    emptyCells += current_puzzle_grid.grid[i].type == DYNAMIC && current_puzzle_grid.grid[i].value == V_None;
   }
-  return true;
+  game_stats = entry->stats;
+  gameSeed = entry->seed;
+  gameFlags = entry->flags;
+  movelog_clear(&moveLog);
+  boardLayerDirty = true; // new clues
+  hints_init(&playHints, &entry->puzzle); // marks every pencil cell dirty
+  hintShown = false;
+
+  gameState = STATE_PLAYING;
+  mistakeCount = 0;
+  selectedRow = -1; 
+  selectedCol = -1;
+  startTime = GetTime(); 
+  elapsed = 0;
+  score = 0; 
 }
 
-// Sudoku solver (Generate/Fills in the complete & valid solution)
-bool fill_grid(Sudoku sudoku_instance, int row, int col) {
-    // Base case: If all rows are filled, the grid is complete
-    if (row == sudoku_instance.rows) {
-        return true;
-    }
-
-    // Calculate next cell coordinates
-    int nextRow = (col == sudoku_instance.cols - 1) ? row + 1 : row;
-    int nextCol = (col + 1) % sudoku_instance.cols;
-
-    CellValue numbers[9] = {V_1, V_2, V_3, V_4, V_5, V_6, V_7, V_8, V_9};
-
-    // Shuffle numbers to randomize puzzle
-    for (int i = 0; i < 9; i++) {
-        int j = rand() % 9;
-        CellValue tmp = numbers[i];
-        numbers[i] = numbers[j];
-        numbers[j] = tmp;
-    }
-
-    // Try each shuffled number
-    for (int i = 0; i < 9; i++) {
-        CellValue current_val = numbers[i];
-        if (is_valid(sudoku_instance, row, col, current_val)) {
-            sudoku_instance.grid[row * sudoku_instance.cols + col].value = current_val;
-            if (fill_grid(sudoku_instance, nextRow, nextCol)) {
-                return true; 
-            }
-            // Backtrack: if the current number doesn't lead to a solution, reset the cell and try the next number
-            sudoku_instance.grid[row * sudoku_instance.cols + col].value = V_None;
-        }
-    }
-    return false;
+// Starts a game from the pool, or switches to STATE_GENERATING until one is ready
+void generate_new_game(Difficulty difficulty) {
+  selectedDifficulty = difficulty;
+  PoolEntry entry;
+  if (pool_pop(&puzzle_pool, difficulty, &entry)) {
+    start_game(&entry);
+  } else if (puzzle_pool.running) {
+    gameState = STATE_GENERATING;
+  } else {
+    // no producer thread: generate inline, the frame stalls but the game still works
+    entry.seed = rng_next64(&puzzle_pool.ctx.rng);
+    entry.flags = 0;
+    corpus_generate(entry.seed, difficulty, entry.flags, &entry.puzzle, &entry.solution);
+    memset(&entry.stats, 0, sizeof(entry.stats));
+    start_game(&entry);
+  }
 }
 
-// Recursively counts the number of solutions and stop once found
-int count_solutions(Sudoku *sudoku_ptr, int limit) {
-    int solutions_found = 0;
-    // go through the grid to find the next empty cell
-    for (int row = 0; row < sudoku_ptr->rows; row++) {
-        for (int col = 0; col < sudoku_ptr->cols; col++) {
-            int i = row * sudoku_ptr->cols + col;
-            if (sudoku_ptr->grid[i].value == V_None) {
-                // Try each possible value (V_1 to V_9)
-                for (CellValue val = V_1; val <= V_9; val++) {
-                    if (is_valid(*sudoku_ptr, row, col, val)) {
-                        sudoku_ptr->grid[i].value = val; 
-                        solutions_found += count_solutions(sudoku_ptr, limit); // Recurse
-
-                        // Backtrack: Always reset the cell after exploring its path
-                        sudoku_ptr->grid[i].value = V_None; // Reset to V_None
-
-                        // Optimization: if enough solutions are found we stop
-                        if (solutions_found >= limit) {
-                            return solutions_found;
-                        }
-                    }
-                }
-                return solutions_found;
-            }
-        }
-    }
-    return 1;
+// Writes a value into a DYNAMIC cell and keeps the counters and pencil marks in step
+void set_cell(int index, CellValue value) {
+  Cell *cell = &current_puzzle_grid.grid[index];
+  emptyCells += (cell->value != V_None) - (value != V_None);
+  cell->value = value;
+  hints_set(&playHints, index, value);
+  hintShown = false;
 }
 
-// Checks for a unique solution
-bool has_unique_solution(Sudoku *sudoku_ptr) {
-    // Create a copy of the puzzle to solve so the original isn't modified
-    Sudoku copy = game_open(sudoku_ptr->rows, sudoku_ptr->cols);
-    memcpy(copy.grid, sudoku_ptr->grid, sudoku_ptr->rows * sudoku_ptr->cols * sizeof(Cell));
-
-    int num_solutions = count_solutions(&copy, 2); 
-    game_close(copy); 
-    return num_solutions == 1; 
+void check_win(void) {
+  if (emptyCells == 0) {
+    gameState = STATE_WIN;
+    score = 1000 - (int)elapsed - (mistakeCount * 100);
+    if (score < 0) {
+      score = 0;
+    }
+  }
 }
 
-// Removes cells from a solved Sudoku grid to create a puzzle
-void remove_cells(Sudoku puzzle_grid, Sudoku solution_grid_ref, int count) {
-    int removed_count = 0;
-    while (removed_count < count) {
-        int row = rand() % puzzle_grid.rows;
-        int col = rand() % puzzle_grid.cols;
-        int idx = row * puzzle_grid.cols + col;
-
-        Cell *cell = &puzzle_grid.grid[idx];
-        if (cell->value == V_None) { 
-            continue; 
-        }
-
-        CellValue backup_value = cell->value;
-        CellType backup_type = cell->type;
-
-        cell->value = V_None;   // Temporarily remove the value (set to V_None)
-        cell->type = DYNAMIC;   // Mark as dynamic (user editable) for solution checking
-
-        // check against the 'puzzle_grid' (which has values removed) but it still needs to be a valid and solvable state.
-        if (!has_unique_solution(&puzzle_grid)) {
-            // If it leads to multiple solutions or no solution, restore the cell
-            cell->value = backup_value;
-            cell->type = FIXED; 
-        } else {
-            removed_count++;
-        }
+// Rebuilds the saved puzzle from its seed and replays its moves; a move that does not fit
+// the puzzle (save from another generator version) drops the rest of the log
+void resume_saved_game(void) {
+  PoolEntry entry;
+  corpus_generate(savedInfo.seed, savedInfo.difficulty, savedInfo.flags, &entry.puzzle, &entry.solution);
+  memset(&entry.stats, 0, sizeof(entry.stats));
+  entry.seed = savedInfo.seed;
+  entry.flags = savedInfo.flags;
+  selectedDifficulty = savedInfo.difficulty;
+  start_game(&entry);
+  for (int n = 0; n < savedMoves.position; n++) {
+    Move move = savedMoves.moves[n];
+    CellValue value = move_new(move);
+    const Cell *cell = &current_puzzle_grid.grid[move.cell];
+    if (cell->type != DYNAMIC || cell->value != move_old(move) ||
+        (value != V_None && value != solution_grid.grid[move.cell].value)) {
+      break;
     }
-
-    // After removing cells copy the
-    // 'puzzle_grid' (with removed cells) to current_puzzle_grid
-    // 'solution_grid_ref' (the original solved grid to the global solution_grid.
-    // This function now generates the initial puzzle and sets the solution
-    for (int i = 0; i < puzzle_grid.rows * puzzle_grid.cols; i++) {
-        if (puzzle_grid.grid[i].value == V_None) {
-            puzzle_grid.grid[i].type = DYNAMIC; 
-        } else {
-            puzzle_grid.grid[i].type = FIXED; 
-        }
+    if (!movelog_push(&moveLog, move.cell, move_old(move), value)) {
+      break;
     }
+    set_cell(move.cell, value);
+  }
+  mistakeCount = savedInfo.mistakes;
+  startTime = GetTime() - savedInfo.elapsed;
+  savedGame = false;
+  resumedGame = true;
+  movelog_free(&savedMoves);
+  check_win();
 }
 
-// Generates a Sudoku puzzle and its unique solution
-void generate_new_game(int cells_to_remove) {
-  // 1. Generate a complete, solved Sudoku board into a temporary grid
-  Sudoku temp_solution = game_open(ROWS, COLS);
-  grid_fill(temp_solution, V_None, DYNAMIC); 
-  fill_grid(temp_solution, 0, 0); // fills 'temp_solution' with a completed and valid solution
-
-  // 2. Copy the complete solution into solution_grid
-  if (solution_grid.grid == NULL) {
-    solution_grid = game_open(ROWS, COLS);
+// Ctrl+Z reverts the last edit, Ctrl+Y (or Ctrl+Shift+Z) reapplies it
+void handle_undo_redo(void) {
+  if (!IsKeyDown(KEY_LEFT_CONTROL) && !IsKeyDown(KEY_RIGHT_CONTROL)) {
+    return;
   }
-  memcpy(solution_grid.grid, temp_solution.grid, ROWS * COLS * sizeof(Cell));
+  bool shift = IsKeyDown(KEY_LEFT_SHIFT) || IsKeyDown(KEY_RIGHT_SHIFT);
+  Move move;
+  if (IsKeyPressed(KEY_Z) && !shift) {
+    if (movelog_undo(&moveLog, &move)) {
+      set_cell(move.cell, move_old(move));
+    }
+  } else if (IsKeyPressed(KEY_Y) || (IsKeyPressed(KEY_Z) && shift)) {
+    if (movelog_redo(&moveLog, &move)) {
+      set_cell(move.cell, move_new(move));
+    }
+  }
+  check_win(); // undoing a clear can fill the last cell
+}
 
-  // 3. Removing cells from a copy of the solution to create the puzzle
-  if (current_puzzle_grid.grid == NULL) {
-    current_puzzle_grid = game_open(ROWS, COLS);
+// Called once per frame before drawing: takes over a puzzle once the producer has one
+void poll_generation(void) {
+  PoolEntry entry;
+  if (gameState == STATE_GENERATING && pool_pop(&puzzle_pool, selectedDifficulty, &entry)) {
+    start_game(&entry);
   }
-  // Start current_puzzle_grid as a copy of the full solution 
-  memcpy(current_puzzle_grid.grid, temp_solution.grid, ROWS * COLS * sizeof(Cell));
-  remove_cells(current_puzzle_grid, solution_grid, cells_to_remove);
-  game_close(temp_solution);
 }
 
 
@@ -280,28 +242,112 @@ void draw_grid_lines(Sudoku sudoku_instance) {
     }
 }
 
-// Draw the numbers in the grid cells
-void draw_values(Sudoku sudoku_instance) {
+// Re-formats and re-measures a HUD line if its value changed since the last frame
+const HudText *hud_text(HudText *hud, const char *format, int value, int fontSize) {
+    if (!hud->valid || hud->value != value) {
+        snprintf(hud->text, sizeof(hud->text), format, value);
+        hud->width = MeasureText(hud->text, fontSize);
+        hud->value = value;
+        hud->valid = true;
+    }
+    return hud;
+}
+
+// Measures the digit glyphs once, draw_values() only looks them up
+void init_render_cache() {
+    boardLayer = LoadRenderTexture(windowWidth, windowHeight);
+    pencilLayer = LoadRenderTexture(windowWidth, windowHeight);
+    for (int v = 1; v <= 9; v++) {
+        digitSize[v] = MeasureTextEx(GetFontDefault(), digitText[v], (float)DIGIT_FONT_SIZE, 0);
+        pencilSize[v] = MeasureTextEx(GetFontDefault(), digitText[v], (float)PENCIL_FONT_SIZE, 0);
+    }
+}
+
+// Draw the numbers of one cell type in the grid cells
+void draw_values(Sudoku sudoku_instance, CellType type) {
     for (int row = 0; row < sudoku_instance.rows; row++) {
         for (int col = 0; col < sudoku_instance.cols; col++) {
             Cell cell = sudoku_instance.grid[row * sudoku_instance.cols + col];
-            if (cell.value != V_None) { // Check for non-V_None
-                char text[2]; // Buffer
-                sprintf(text, "%d", (int)cell.value);
+            if (cell.value != V_None && cell.type == type) { // Check for non-V_None
                 Color color = (cell.type == FIXED) ? BLACK : BLUE; // fixed = black, userinput/dynamic = blue
 
-                int fontSize = 30;
-                // Measure text size 
-                Vector2 textSize = MeasureTextEx(GetFontDefault(), text, (float)fontSize, 0); 
-
                 // Calculate position to center the text within the cell
+                Vector2 textSize = digitSize[cell.value];
                 float x = (float)col * cellWidth + (cellWidth - textSize.x) / 2.0f;
                 float y = (float)row * cellHeight + (cellHeight - textSize.y) / 2.0f;
 
-                DrawText(text, (int)x, (int)y, fontSize, color);
+                DrawText(digitText[cell.value], (int)x, (int)y, DIGIT_FONT_SIZE, color);
+            }
+        }
+    }
+}
+
+// Redraws the cached grid lines + FIXED clues, must run outside BeginDrawing()
+void update_board_layer() {
+    if (!boardLayerDirty || current_puzzle_grid.grid == NULL) {
+        return;
+    }
+    BeginTextureMode(boardLayer);
+    ClearBackground(RAYWHITE);
+    draw_grid_lines(current_puzzle_grid);
+    draw_values(current_puzzle_grid, FIXED);
+    EndTextureMode();
+    boardLayerDirty = false;
+}
+
+// Re-renders the pencil marks of changed cells only, must run outside BeginDrawing()
+// While hidden the dirty bits just pile up, so showing them again catches up
+void update_pencil_layer() {
+    uint64_t dirty[2];
+    if (!showCandidates || current_puzzle_grid.grid == NULL || !hints_take_dirty(&playHints, dirty)) {
+        return;
+    }
+    BeginTextureMode(pencilLayer);
+    for (int i = 0; i < ROWS * COLS; i++) {
+        if (!((dirty[i >> 6] >> (i & 63)) & 1)) {
+            continue;
+        }
+        int x = (i % COLS) * cellWidth, y = (i / COLS) * cellHeight;
+        BeginScissorMode(x, y, cellWidth, cellHeight);
+        ClearBackground(BLANK);
+        EndScissorMode();
+        // 3x3 layout, value v in slot v - 1
+        for (int v = 1; v <= 9; v++) {
+            if (playHints.candidates[i] & VALUE_BIT(v)) {
+                float slotX = x + ((v - 1) % 3) * (cellWidth / 3.0f) + (cellWidth / 3.0f - pencilSize[v].x) / 2.0f;
+                float slotY = y + ((v - 1) / 3) * (cellHeight / 3.0f) + (cellHeight / 3.0f - pencilSize[v].y) / 2.0f;
+                DrawText(digitText[v], (int)slotX, (int)slotY, PENCIL_FONT_SIZE, GRAY);
             }
         }
     }
+    EndTextureMode();
+}
+
+// cached layers (flipped, render textures are stored bottom-up), then the player's digits
+void draw_board() {
+    Rectangle flipped = {0, 0, (float)windowWidth, -(float)windowHeight};
+    DrawTextureRec(boardLayer.texture, flipped, (Vector2){0, 0}, WHITE);
+    if (showCandidates) {
+        DrawTextureRec(pencilLayer.texture, flipped, (Vector2){0, 0}, WHITE);
+    }
+    draw_values(current_puzzle_grid, DYNAMIC);
+}
+
+// Hint from the last H press: its cell outlined, technique and value at the bottom
+void draw_hint() {
+    if (!hintShown) {
+        return;
+    }
+    char text[64];
+    if (shownHint.cell < 0) {
+        snprintf(text, sizeof(text), "Hint: no single left, look for locked candidates");
+    } else {
+        DrawRectangleLines((shownHint.cell % COLS) * cellWidth + 2, (shownHint.cell / COLS) * cellHeight + 2,
+                           cellWidth - 4, cellHeight - 4, ORANGE);
+        snprintf(text, sizeof(text), "Hint: %s, %d", technique_name(shownHint.technique), shownHint.value);
+    }
+    int fontSize = 20;
+    DrawText(text, windowWidth / 2 - MeasureText(text, fontSize) / 2, windowHeight - fontSize - 10, fontSize, ORANGE);
 }
 
 // draw selection rectangle around the selected cell
@@ -351,6 +397,122 @@ void draw_menu() {
     int hintFontSize = 20;
     float hintTextWidth = MeasureText(hint, hintFontSize);
     DrawText(hint, screenCenterX - (int)(hintTextWidth / 2), currentY, hintFontSize, GRAY);
+
+    if (savedGame) {
+        currentY += lineHeight;
+        const char* resume = "S. Resume saved game";
+        float resumeTextWidth = MeasureText(resume, optionFontSize);
+        DrawText(resume, screenCenterX - (int)(resumeTextWidth / 2), currentY, optionFontSize, DARKGREEN);
+    }
+}
+
+// shown while the pool is still empty for the chosen difficulty
+void draw_generating() {
+    const char* msg = "Generating puzzle...";
+    int fontSize = 30;
+    float msgWidth = MeasureText(msg, fontSize);
+    DrawText(msg, windowWidth / 2 - (int)(msgWidth / 2), windowHeight / 2 - fontSize / 2, fontSize, DARKGRAY);
+}
+
+#if defined(SUDOKU_STATS)
+// solver counters behind the current puzzle, toggled with F3
+void draw_stats_overlay() {
+    const SolverStats *st = &game_stats;
+    char lines[7][64];
+    snprintf(lines[0], sizeof(lines[0]), "fill: %.2f ms", st->fill_ns / 1e6);
+    snprintf(lines[1], sizeof(lines[1]), "dig: %.2f ms", st->dig_ns / 1e6);
+    snprintf(lines[2], sizeof(lines[2]), "nodes: %llu", (unsigned long long)st->nodes);
+    snprintf(lines[3], sizeof(lines[3]), "backtracks: %llu", (unsigned long long)st->backtracks);
+    snprintf(lines[4], sizeof(lines[4]), "masks: %llu", (unsigned long long)st->mask_evaluations);
+    snprintf(lines[5], sizeof(lines[5]), "removals ok: %llu", (unsigned long long)st->removals_accepted);
+    snprintf(lines[6], sizeof(lines[6]), "removals rejected: %llu", (unsigned long long)st->removals_rejected);
+
+    int count = (int)(sizeof(lines) / sizeof(lines[0]));
+    int fontSize = 20;
+    int x = 10, y = windowHeight - count * (fontSize + 4) - 20;
+    DrawRectangle(x - 5, y - 5, 260, count * (fontSize + 4) + 10, Fade(BLACK, 0.7f));
+    for (int i = 0; i < count; i++) {
+        DrawText(lines[i], x, y + i * (fontSize + 4), fontSize, RAYWHITE);
+    }
+}
+#endif
+
+// --- Redraw Scheduling ---
+
+// Screens without a clock or a pending puzzle only change on input
+bool screen_is_static() {
+    if (startupPending) {
+        return false; // finish_startup() must not wait for the first input event
+    }
+    return gameState == STATE_MENU || gameState == STATE_WIN || gameState == STATE_LOSE;
+}
+
+// Static screens block in PollInputEvents() until the next input event; the others sleep
+// and poll so the HUD timer and the producer finishing a puzzle get noticed
+void update_event_waiting() {
+    if (screen_is_static()) {
+        EnableEventWaiting();
+    } else {
+        DisableEventWaiting();
+    }
+}
+
+// Drains the input queues of the last poll, true if anything was pressed or scrolled
+bool input_pending() {
+    bool pending = false;
+    while (GetKeyPressed() != 0) {
+        pending = true;
+    }
+    for (int button = MOUSE_BUTTON_LEFT; button <= MOUSE_BUTTON_RIGHT; button++) {
+        pending |= IsMouseButtonPressed(button);
+    }
+    return pending || GetMouseWheelMove() != 0.0f || IsWindowResized();
+}
+
+// True if the next frame would look different from the last one drawn
+bool redraw_needed() {
+    if (gameState != drawnState || boardLayerDirty) {
+        return true;
+    }
+    if (showCandidates && (playHints.dirty[0] | playHints.dirty[1]) != 0) {
+        return true; // pencil marks to catch up on
+    }
+    if (gameState == STATE_PLAYING && (int)(GetTime() - startTime) != drawnSecond) {
+        return true; // HUD clock ticked
+    }
+    return input_pending();
+}
+
+// frameState is the screen the frame drew; input handled during the frame may already
+// have switched gameState, and then the new screen still needs a frame of its own
+void end_frame(GameState frameState) {
+    drawnState = frameState;
+    drawnSecond = (int)elapsed;
+    if (gameState != frameState) {
+        DisableEventWaiting(); // don't block in EndDrawing() before the new screen is up
+    } else {
+        update_event_waiting();
+    }
+    EndDrawing();
+    if (firstFrameTime < 0) {
+        firstFrameTime = GetTime();
+    }
+}
+
+// Everything the first frame can do without; runs before the second frame handles input
+void finish_startup() {
+  TraceLog(LOG_INFO, "SUDOKU: first frame %.1f ms after InitWindow()", firstFrameTime * 1000.0);
+  init_render_cache();
+  pool_load(&puzzle_pool, POOL_CACHE_FILE);
+  if (corpus_open(&puzzle_corpus, CORPUS_FILE)) {
+    pool_attach_corpus(&puzzle_pool, &puzzle_corpus); // nothing to generate for what it covers
+  }
+  pool_start(&puzzle_pool);
+  savedGame = snapshot_load(SAVE_FILE, &savedInfo, &savedMoves);
+  if (savedGame) {
+    drawnState = -1; // the menu gains its resume line
+  }
+  startupPending = false;
 }
 
 // --- Main Game Loop ---
@@ -358,7 +520,7 @@ int main() {
   // raylib window
   InitWindow(windowWidth, windowHeight, "Sudoku with ty and denn");
   SetTargetFPS(60); 
-  srand((unsigned int)time(0)); 
+  pool_init(&puzzle_pool, (uint64_t)time(0)); // no I/O or threads yet, see finish_startup()
 
   // sudoku
   current_puzzle_grid.grid = NULL;
@@ -366,6 +528,23 @@ int main() {
 
     // game loop
     while (!WindowShouldClose()) { 
+        if (startupPending && drawnState >= 0) {
+            finish_startup();
+        }
+        poll_generation(); // frame boundary: safe to swap in a new puzzle
+        if (!redraw_needed()) {
+            // idle: keep the last frame on screen, just wait for input
+            update_event_waiting();
+            if (!screen_is_static()) {
+                WaitTime(IDLE_POLL_INTERVAL);
+            }
+            PollInputEvents();
+            continue;
+        }
+        update_board_layer();
+        update_pencil_layer();
+
+        GameState frameState = gameState;
         BeginDrawing(); 
         ClearBackground(RAYWHITE); 
 
@@ -375,24 +554,23 @@ int main() {
             // difficulty selection
             if (IsKeyPressed(KEY_ONE) || IsKeyPressed(KEY_TWO) || IsKeyPressed(KEY_THREE)) {
                 if (IsKeyPressed(KEY_ONE)) {
-                    selectedDifficulty = EASY_CELLS_REMOVED;
+                    generate_new_game(DIFFICULTY_EASY);
                 } else if (IsKeyPressed(KEY_TWO)) {
-                    selectedDifficulty = MEDIUM_CELLS_REMOVED;
+                    generate_new_game(DIFFICULTY_MEDIUM);
                 } else {
-                    selectedDifficulty = HARD_CELLS_REMOVED;
+                    generate_new_game(DIFFICULTY_HARD);
                 }
-
-                gameState = STATE_PLAYING;
-                generate_new_game(selectedDifficulty); // generate puzzle and solution
-                mistakeCount = 0;
-                selectedRow = -1; 
-                selectedCol = -1;
-                startTime = GetTime(); 
-                elapsed = 0;
-                score = 0; 
-                EndDrawing(); 
+                end_frame(frameState);
                 continue; 
             }
+            if (savedGame && IsKeyPressed(KEY_S)) {
+                resume_saved_game();
+                end_frame(frameState);
+                continue;
+            }
+
+        } else if (gameState == STATE_GENERATING) {
+            draw_generating();
 
         } else if (gameState == STATE_PLAYING) {
             elapsed = GetTime() - startTime; 
@@ -422,21 +600,12 @@ int main() {
 
                             // Check against the stored solution
                             if (guess == correct_value) {
-                                current_cell->value = guess; 
-                                bool all_filled = true;
-                                for (int i = 0; i < ROWS * COLS; i++) {
-                                    if (current_puzzle_grid.grid[i].type == DYNAMIC && current_puzzle_grid.grid[i].value == V_None) {
-                                        all_filled = false;
-                                        break;
-                                    }
-                                }
-                                if (all_filled) {
-                                    gameState = STATE_WIN;
-                                    score = 1000 - (int)elapsed - (mistakeCount * 100); 
-                                    if (score < 0) {
-                                      score = 0;
+                                if (current_cell->value != guess) {
+                                    if (movelog_push(&moveLog, selectedRow * COLS + selectedCol, current_cell->value, guess)) {
+                                        set_cell(selectedRow * COLS + selectedCol, guess);
                                     }
                                 }
+                                check_win();
                             } else {
                                 mistakeCount++;
                                 if (mistakeCount >= 3) {
@@ -450,17 +619,29 @@ int main() {
                 // backspace/delete to clear userinput
                 if ((IsKeyPressed(KEY_BACKSPACE) || IsKeyPressed(KEY_DELETE)) && selectedRow >= 0 && selectedCol >= 0) {
                     Cell *current_cell = &current_puzzle_grid.grid[selectedRow * COLS + selectedCol];
-                    if (current_cell->type == DYNAMIC) {
-                        current_cell->value = V_None; 
+                    if (current_cell->type == DYNAMIC && current_cell->value != V_None) {
+                        if (movelog_push(&moveLog, selectedRow * COLS + selectedCol, current_cell->value, V_None)) {
+                            set_cell(selectedRow * COLS + selectedCol, V_None);
+                        }
                     }
                 }
+                handle_undo_redo();
+
+                // C toggles pencil marks, H shows the next logical move
+                if (IsKeyPressed(KEY_C)) {
+                    showCandidates = !showCandidates;
+                }
+                if (IsKeyPressed(KEY_H)) {
+                    shownHint = hints_next_move(&playHints);
+                    hintShown = true;
+                }
 
             }
 
             // Always draw grid and values in playing state
-            draw_grid_lines(current_puzzle_grid);
-            draw_values(current_puzzle_grid);
+            draw_board();
             draw_selection();
+            draw_hint();
 
             // --- Game Information Display ---
             int topInfoYOffset = 10;
@@ -468,21 +649,25 @@ int main() {
             int screenMiddleX = windowWidth / 2;
 
             // Display Mistakes (top left)
-            char info[64];
-            sprintf(info, "Mistakes: %d / 3", mistakeCount);
-            DrawText(info, 10, topInfoYOffset, topInfoFontSize, RED);
+            const HudText *info = hud_text(&hudMistakes, "Mistakes: %d / 3", mistakeCount, topInfoFontSize);
+            DrawText(info->text, 10, topInfoYOffset, topInfoFontSize, RED);
 
-            // Display Time (top center)
-            char timeText[64];
-            sprintf(timeText, "Time: %.0f sec", elapsed);
-            float timeTextWidth = MeasureText(timeText, topInfoFontSize);
-            DrawText(timeText, screenMiddleX - (int)(timeTextWidth / 2), topInfoYOffset, topInfoFontSize, DARKGRAY);
+            // Display Time (top center), whole seconds like the redraw tick
+            const HudText *timeText = hud_text(&hudTime, "Time: %d sec", (int)elapsed, topInfoFontSize);
+            DrawText(timeText->text, screenMiddleX - timeText->width / 2, topInfoYOffset, topInfoFontSize, DARKGRAY);
 
             // Display Score (top right)
-            char currentScoreText[64];
-            sprintf(currentScoreText, "Score: %d", score);
-            float scoreTextWidth = MeasureText(currentScoreText, topInfoFontSize);
-            DrawText(currentScoreText, windowWidth - (int)scoreTextWidth - 10, topInfoYOffset, topInfoFontSize, DARKGREEN);
+            const HudText *currentScoreText = hud_text(&hudScore, "Score: %d", score, topInfoFontSize);
+            DrawText(currentScoreText->text, windowWidth - currentScoreText->width - 10, topInfoYOffset, topInfoFontSize, DARKGREEN);
+
+#if defined(SUDOKU_STATS)
+            if (IsKeyPressed(KEY_F3)) {
+                showStats = !showStats;
+            }
+            if (showStats) {
+                draw_stats_overlay();
+            }
+#endif
 
 
         } else if (gameState == STATE_WIN) {
@@ -545,9 +730,27 @@ int main() {
             }
         }
 
-        EndDrawing(); 
+        end_frame(frameState);
     }
 
+  // an unfinished game is kept for the next start; a resumed one that ended is done with
+  if (gameState == STATE_PLAYING) {
+    SnapshotInfo info = {gameSeed, selectedDifficulty, gameFlags, (uint8_t)mistakeCount, (uint32_t)elapsed};
+    snapshot_save(SAVE_FILE, &info, &moveLog);
+  } else if (resumedGame) {
+    remove(SAVE_FILE);
+  }
+  movelog_free(&moveLog);
+  movelog_free(&savedMoves);
+  pool_stop(&puzzle_pool);
+  if (!startupPending) {
+    // closed before the cache was even loaded: leave it as it is
+    pool_save(&puzzle_pool, POOL_CACHE_FILE);
+    UnloadRenderTexture(boardLayer);
+    UnloadRenderTexture(pencilLayer);
+  }
+  pool_destroy(&puzzle_pool);
+  corpus_close(&puzzle_corpus);
   game_close(current_puzzle_grid);
   game_close(solution_grid);     
   CloseWindow(); 
@@ -0,0 +1,1443 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L // clock_gettime() under -std=c17
+#endif
+
+#include "sudoku_core.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h> // For memcpy
+#include <time.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h> // QueryPerformanceCounter()
+#endif
+
+SolverStrategy solver_strategy = SOLVER_MRV;
+
+#if defined(SUDOKU_STATS)
+THREAD_LOCAL SolverStats solver_stats;
+#endif
+
+// --- Difficulty ---
+
+int difficulty_cells_removed(Difficulty difficulty) {
+  static const int cells[DIFFICULTY_COUNT] = {EASY_CELLS_REMOVED, MEDIUM_CELLS_REMOVED, HARD_CELLS_REMOVED};
+  return cells[difficulty];
+}
+
+const char *difficulty_name(Difficulty difficulty) {
+  static const char *names[DIFFICULTY_COUNT] = {"easy", "medium", "hard"};
+  return names[difficulty];
+}
+
+// --- Generator Context ---
+
+void generator_init(GeneratorContext *ctx, uint64_t seed) {
+  rng_seed(&ctx->rng, seed);
+  ctx->strategy = solver_strategy;
+  ctx->symmetric = false;
+  ctx->incremental = true;
+  ctx->fill = FILL_BACKTRACK;
+  memset(&ctx->stats, 0, sizeof(ctx->stats));
+}
+
+// --- Sudoku Functions ---
+
+// Initializes a new Sudoku grid by allocating memory
+Sudoku game_open(size_t rows, size_t cols) {
+  Sudoku newSudokuGrid = {rows, cols, calloc(rows * cols, sizeof(Cell))};
+  if (newSudokuGrid.grid == NULL) {
+    // allocation error gracefully
+    fprintf(stderr, "Error: Failed to allocate memory\n");
+    exit(EXIT_FAILURE); 
+  }
+  return newSudokuGrid;
+}
+
+// Frees the memory/avoid leaks
+void game_close(Sudoku sudoku_instance) {
+  if (sudoku_instance.grid != NULL) {
+    free(sudoku_instance.grid);
+    sudoku_instance.grid = NULL; 
+  }
+}
+
+// Fills all the grid with a specified value and sets all cell types 
+void grid_fill(Sudoku sudoku_instance, CellValue val, CellType type) {
+  for (size_t i = 0; i < sudoku_instance.rows * sudoku_instance.cols; i++) {
+    sudoku_instance.grid[i].value = val;
+    sudoku_instance.grid[i].type = type;
+  }
+}
+
+// --- Lookup Tables ---
+// Written out for 9x9 so cell -> row/col/box, unit -> cells and cell -> peers are plain
+// loads in the solver loops. The N x N boards in sudoku_geometry_template.h keep computing
+// theirs with compile-time divisors instead.
+_Static_assert(ROWS == 9 && COLS == 9, "lookup tables are written for 9x9");
+
+#define PEER_COUNT 20 // cells sharing a row, column or box with a cell
+
+static const uint8_t cell_row[CELL_COUNT] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 1, 1, 1, 1, 1,
+  2, 2, 2, 2, 2, 2, 2, 2, 2,
+  3, 3, 3, 3, 3, 3, 3, 3, 3,
+  4, 4, 4, 4, 4, 4, 4, 4, 4,
+  5, 5, 5, 5, 5, 5, 5, 5, 5,
+  6, 6, 6, 6, 6, 6, 6, 6, 6,
+  7, 7, 7, 7, 7, 7, 7, 7, 7,
+  8, 8, 8, 8, 8, 8, 8, 8, 8,
+};
+
+static const uint8_t cell_col[CELL_COUNT] = {
+  0, 1, 2, 3, 4, 5, 6, 7, 8,
+  0, 1, 2, 3, 4, 5, 6, 7, 8,
+  0, 1, 2, 3, 4, 5, 6, 7, 8,
+  0, 1, 2, 3, 4, 5, 6, 7, 8,
+  0, 1, 2, 3, 4, 5, 6, 7, 8,
+  0, 1, 2, 3, 4, 5, 6, 7, 8,
+  0, 1, 2, 3, 4, 5, 6, 7, 8,
+  0, 1, 2, 3, 4, 5, 6, 7, 8,
+  0, 1, 2, 3, 4, 5, 6, 7, 8,
+};
+
+static const uint8_t cell_box[CELL_COUNT] = {
+  0, 0, 0, 1, 1, 1, 2, 2, 2,
+  0, 0, 0, 1, 1, 1, 2, 2, 2,
+  0, 0, 0, 1, 1, 1, 2, 2, 2,
+  3, 3, 3, 4, 4, 4, 5, 5, 5,
+  3, 3, 3, 4, 4, 4, 5, 5, 5,
+  3, 3, 3, 4, 4, 4, 5, 5, 5,
+  6, 6, 6, 7, 7, 7, 8, 8, 8,
+  6, 6, 6, 7, 7, 7, 8, 8, 8,
+  6, 6, 6, 7, 7, 7, 8, 8, 8,
+};
+
+// Cells of unit u: rows 0..8, columns 9..17, boxes 18..26
+static const uint8_t unit_cells[3 * ROWS][ROWS] = {
+  {0, 1, 2, 3, 4, 5, 6, 7, 8},
+  {9, 10, 11, 12, 13, 14, 15, 16, 17},
+  {18, 19, 20, 21, 22, 23, 24, 25, 26},
+  {27, 28, 29, 30, 31, 32, 33, 34, 35},
+  {36, 37, 38, 39, 40, 41, 42, 43, 44},
+  {45, 46, 47, 48, 49, 50, 51, 52, 53},
+  {54, 55, 56, 57, 58, 59, 60, 61, 62},
+  {63, 64, 65, 66, 67, 68, 69, 70, 71},
+  {72, 73, 74, 75, 76, 77, 78, 79, 80},
+  {0, 9, 18, 27, 36, 45, 54, 63, 72},
+  {1, 10, 19, 28, 37, 46, 55, 64, 73},
+  {2, 11, 20, 29, 38, 47, 56, 65, 74},
+  {3, 12, 21, 30, 39, 48, 57, 66, 75},
+  {4, 13, 22, 31, 40, 49, 58, 67, 76},
+  {5, 14, 23, 32, 41, 50, 59, 68, 77},
+  {6, 15, 24, 33, 42, 51, 60, 69, 78},
+  {7, 16, 25, 34, 43, 52, 61, 70, 79},
+  {8, 17, 26, 35, 44, 53, 62, 71, 80},
+  {0, 1, 2, 9, 10, 11, 18, 19, 20},
+  {3, 4, 5, 12, 13, 14, 21, 22, 23},
+  {6, 7, 8, 15, 16, 17, 24, 25, 26},
+  {27, 28, 29, 36, 37, 38, 45, 46, 47},
+  {30, 31, 32, 39, 40, 41, 48, 49, 50},
+  {33, 34, 35, 42, 43, 44, 51, 52, 53},
+  {54, 55, 56, 63, 64, 65, 72, 73, 74},
+  {57, 58, 59, 66, 67, 68, 75, 76, 77},
+  {60, 61, 62, 69, 70, 71, 78, 79, 80},
+};
+
+// Peers of every cell in ascending order
+static const uint8_t cell_peers[CELL_COUNT][PEER_COUNT] = {
+  {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 18, 19, 20, 27, 36, 45, 54, 63, 72},
+  {0, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 18, 19, 20, 28, 37, 46, 55, 64, 73},
+  {0, 1, 3, 4, 5, 6, 7, 8, 9, 10, 11, 18, 19, 20, 29, 38, 47, 56, 65, 74},
+  {0, 1, 2, 4, 5, 6, 7, 8, 12, 13, 14, 21, 22, 23, 30, 39, 48, 57, 66, 75},
+  {0, 1, 2, 3, 5, 6, 7, 8, 12, 13, 14, 21, 22, 23, 31, 40, 49, 58, 67, 76},
+  {0, 1, 2, 3, 4, 6, 7, 8, 12, 13, 14, 21, 22, 23, 32, 41, 50, 59, 68, 77},
+  {0, 1, 2, 3, 4, 5, 7, 8, 15, 16, 17, 24, 25, 26, 33, 42, 51, 60, 69, 78},
+  {0, 1, 2, 3, 4, 5, 6, 8, 15, 16, 17, 24, 25, 26, 34, 43, 52, 61, 70, 79},
+  {0, 1, 2, 3, 4, 5, 6, 7, 15, 16, 17, 24, 25, 26, 35, 44, 53, 62, 71, 80},
+  {0, 1, 2, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 27, 36, 45, 54, 63, 72},
+  {0, 1, 2, 9, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 28, 37, 46, 55, 64, 73},
+  {0, 1, 2, 9, 10, 12, 13, 14, 15, 16, 17, 18, 19, 20, 29, 38, 47, 56, 65, 74},
+  {3, 4, 5, 9, 10, 11, 13, 14, 15, 16, 17, 21, 22, 23, 30, 39, 48, 57, 66, 75},
+  {3, 4, 5, 9, 10, 11, 12, 14, 15, 16, 17, 21, 22, 23, 31, 40, 49, 58, 67, 76},
+  {3, 4, 5, 9, 10, 11, 12, 13, 15, 16, 17, 21, 22, 23, 32, 41, 50, 59, 68, 77},
+  {6, 7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 24, 25, 26, 33, 42, 51, 60, 69, 78},
+  {6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 17, 24, 25, 26, 34, 43, 52, 61, 70, 79},
+  {6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 24, 25, 26, 35, 44, 53, 62, 71, 80},
+  {0, 1, 2, 9, 10, 11, 19, 20, 21, 22, 23, 24, 25, 26, 27, 36, 45, 54, 63, 72},
+  {0, 1, 2, 9, 10, 11, 18, 20, 21, 22, 23, 24, 25, 26, 28, 37, 46, 55, 64, 73},
+  {0, 1, 2, 9, 10, 11, 18, 19, 21, 22, 23, 24, 25, 26, 29, 38, 47, 56, 65, 74},
+  {3, 4, 5, 12, 13, 14, 18, 19, 20, 22, 23, 24, 25, 26, 30, 39, 48, 57, 66, 75},
+  {3, 4, 5, 12, 13, 14, 18, 19, 20, 21, 23, 24, 25, 26, 31, 40, 49, 58, 67, 76},
+  {3, 4, 5, 12, 13, 14, 18, 19, 20, 21, 22, 24, 25, 26, 32, 41, 50, 59, 68, 77},
+  {6, 7, 8, 15, 16, 17, 18, 19, 20, 21, 22, 23, 25, 26, 33, 42, 51, 60, 69, 78},
+  {6, 7, 8, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 26, 34, 43, 52, 61, 70, 79},
+  {6, 7, 8, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 35, 44, 53, 62, 71, 80},
+  {0, 9, 18, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 45, 46, 47, 54, 63, 72},
+  {1, 10, 19, 27, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 45, 46, 47, 55, 64, 73},
+  {2, 11, 20, 27, 28, 30, 31, 32, 33, 34, 35, 36, 37, 38, 45, 46, 47, 56, 65, 74},
+  {3, 12, 21, 27, 28, 29, 31, 32, 33, 34, 35, 39, 40, 41, 48, 49, 50, 57, 66, 75},
+  {4, 13, 22, 27, 28, 29, 30, 32, 33, 34, 35, 39, 40, 41, 48, 49, 50, 58, 67, 76},
+  {5, 14, 23, 27, 28, 29, 30, 31, 33, 34, 35, 39, 40, 41, 48, 49, 50, 59, 68, 77},
+  {6, 15, 24, 27, 28, 29, 30, 31, 32, 34, 35, 42, 43, 44, 51, 52, 53, 60, 69, 78},
+  {7, 16, 25, 27, 28, 29, 30, 31, 32, 33, 35, 42, 43, 44, 51, 52, 53, 61, 70, 79},
+  {8, 17, 26, 27, 28, 29, 30, 31, 32, 33, 34, 42, 43, 44, 51, 52, 53, 62, 71, 80},
+  {0, 9, 18, 27, 28, 29, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 54, 63, 72},
+  {1, 10, 19, 27, 28, 29, 36, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 55, 64, 73},
+  {2, 11, 20, 27, 28, 29, 36, 37, 39, 40, 41, 42, 43, 44, 45, 46, 47, 56, 65, 74},
+  {3, 12, 21, 30, 31, 32, 36, 37, 38, 40, 41, 42, 43, 44, 48, 49, 50, 57, 66, 75},
+  {4, 13, 22, 30, 31, 32, 36, 37, 38, 39, 41, 42, 43, 44, 48, 49, 50, 58, 67, 76},
+  {5, 14, 23, 30, 31, 32, 36, 37, 38, 39, 40, 42, 43, 44, 48, 49, 50, 59, 68, 77},
+  {6, 15, 24, 33, 34, 35, 36, 37, 38, 39, 40, 41, 43, 44, 51, 52, 53, 60, 69, 78},
+  {7, 16, 25, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 44, 51, 52, 53, 61, 70, 79},
+  {8, 17, 26, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 51, 52, 53, 62, 71, 80},
+  {0, 9, 18, 27, 28, 29, 36, 37, 38, 46, 47, 48, 49, 50, 51, 52, 53, 54, 63, 72},
+  {1, 10, 19, 27, 28, 29, 36, 37, 38, 45, 47, 48, 49, 50, 51, 52, 53, 55, 64, 73},
+  {2, 11, 20, 27, 28, 29, 36, 37, 38, 45, 46, 48, 49, 50, 51, 52, 53, 56, 65, 74},
+  {3, 12, 21, 30, 31, 32, 39, 40, 41, 45, 46, 47, 49, 50, 51, 52, 53, 57, 66, 75},
+  {4, 13, 22, 30, 31, 32, 39, 40, 41, 45, 46, 47, 48, 50, 51, 52, 53, 58, 67, 76},
+  {5, 14, 23, 30, 31, 32, 39, 40, 41, 45, 46, 47, 48, 49, 51, 52, 53, 59, 68, 77},
+  {6, 15, 24, 33, 34, 35, 42, 43, 44, 45, 46, 47, 48, 49, 50, 52, 53, 60, 69, 78},
+  {7, 16, 25, 33, 34, 35, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 53, 61, 70, 79},
+  {8, 17, 26, 33, 34, 35, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 62, 71, 80},
+  {0, 9, 18, 27, 36, 45, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 72, 73, 74},
+  {1, 10, 19, 28, 37, 46, 54, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 72, 73, 74},
+  {2, 11, 20, 29, 38, 47, 54, 55, 57, 58, 59, 60, 61, 62, 63, 64, 65, 72, 73, 74},
+  {3, 12, 21, 30, 39, 48, 54, 55, 56, 58, 59, 60, 61, 62, 66, 67, 68, 75, 76, 77},
+  {4, 13, 22, 31, 40, 49, 54, 55, 56, 57, 59, 60, 61, 62, 66, 67, 68, 75, 76, 77},
+  {5, 14, 23, 32, 41, 50, 54, 55, 56, 57, 58, 60, 61, 62, 66, 67, 68, 75, 76, 77},
+  {6, 15, 24, 33, 42, 51, 54, 55, 56, 57, 58, 59, 61, 62, 69, 70, 71, 78, 79, 80},
+  {7, 16, 25, 34, 43, 52, 54, 55, 56, 57, 58, 59, 60, 62, 69, 70, 71, 78, 79, 80},
+  {8, 17, 26, 35, 44, 53, 54, 55, 56, 57, 58, 59, 60, 61, 69, 70, 71, 78, 79, 80},
+  {0, 9, 18, 27, 36, 45, 54, 55, 56, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74},
+  {1, 10, 19, 28, 37, 46, 54, 55, 56, 63, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74},
+  {2, 11, 20, 29, 38, 47, 54, 55, 56, 63, 64, 66, 67, 68, 69, 70, 71, 72, 73, 74},
+  {3, 12, 21, 30, 39, 48, 57, 58, 59, 63, 64, 65, 67, 68, 69, 70, 71, 75, 76, 77},
+  {4, 13, 22, 31, 40, 49, 57, 58, 59, 63, 64, 65, 66, 68, 69, 70, 71, 75, 76, 77},
+  {5, 14, 23, 32, 41, 50, 57, 58, 59, 63, 64, 65, 66, 67, 69, 70, 71, 75, 76, 77},
+  {6, 15, 24, 33, 42, 51, 60, 61, 62, 63, 64, 65, 66, 67, 68, 70, 71, 78, 79, 80},
+  {7, 16, 25, 34, 43, 52, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 71, 78, 79, 80},
+  {8, 17, 26, 35, 44, 53, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 78, 79, 80},
+  {0, 9, 18, 27, 36, 45, 54, 55, 56, 63, 64, 65, 73, 74, 75, 76, 77, 78, 79, 80},
+  {1, 10, 19, 28, 37, 46, 54, 55, 56, 63, 64, 65, 72, 74, 75, 76, 77, 78, 79, 80},
+  {2, 11, 20, 29, 38, 47, 54, 55, 56, 63, 64, 65, 72, 73, 75, 76, 77, 78, 79, 80},
+  {3, 12, 21, 30, 39, 48, 57, 58, 59, 66, 67, 68, 72, 73, 74, 76, 77, 78, 79, 80},
+  {4, 13, 22, 31, 40, 49, 57, 58, 59, 66, 67, 68, 72, 73, 74, 75, 77, 78, 79, 80},
+  {5, 14, 23, 32, 41, 50, 57, 58, 59, 66, 67, 68, 72, 73, 74, 75, 76, 78, 79, 80},
+  {6, 15, 24, 33, 42, 51, 60, 61, 62, 69, 70, 71, 72, 73, 74, 75, 76, 77, 79, 80},
+  {7, 16, 25, 34, 43, 52, 60, 61, 62, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 80},
+  {8, 17, 26, 35, 44, 53, 60, 61, 62, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79},
+};
+
+// --- Packed Board ---
+
+// Packs a Cell grid (ROWS x COLS) into a PackedBoard
+void board_from_sudoku(PackedBoard *board, const Sudoku *sudoku_ptr) {
+  memset(board, 0, sizeof(*board));
+  for (int i = 0; i < CELL_COUNT; i++) {
+    board->cells[i] = (uint8_t)sudoku_ptr->grid[i].value;
+    board_set_fixed(board, i, sudoku_ptr->grid[i].type == FIXED);
+  }
+}
+
+// Unpacks a PackedBoard into an already allocated ROWS x COLS Cell grid
+void board_to_sudoku(Sudoku *sudoku_ptr, const PackedBoard *board) {
+  for (int i = 0; i < CELL_COUNT; i++) {
+    sudoku_ptr->grid[i].value = (CellValue)board->cells[i];
+    sudoku_ptr->grid[i].type = board_is_fixed(board, i) ? FIXED : DYNAMIC;
+  }
+}
+
+// Builds the row/col/box masks from the board's cells
+void board_masks_build(BoardMasks *masks, const PackedBoard *board) {
+  memset(masks, 0, sizeof(*masks));
+  for (int i = 0; i < CELL_COUNT; i++) {
+    int val = board->cells[i];
+    if (val != V_None) {
+      masks->row_used[cell_row[i]] |= VALUE_BIT(val);
+      masks->col_used[cell_col[i]] |= VALUE_BIT(val);
+      masks->box_used[cell_box[i]] |= VALUE_BIT(val);
+    }
+  }
+}
+
+// Same walk as board_masks_build(), stopping at the first value already used in its unit
+bool board_consistent(const PackedBoard *board) {
+  BoardMasks masks = {0};
+  for (int i = 0; i < CELL_COUNT; i++) {
+    if (board->cells[i] == V_None) {
+      continue;
+    }
+    int row = cell_row[i], col = cell_col[i], box = cell_box[i];
+    uint16_t bit = (uint16_t)VALUE_BIT(board->cells[i]);
+    if ((masks.row_used[row] | masks.col_used[col] | masks.box_used[box]) & bit) {
+      return false;
+    }
+    masks.row_used[row] |= bit;
+    masks.col_used[col] |= bit;
+    masks.box_used[box] |= bit;
+  }
+  return true;
+}
+
+bool board_solved(const PackedBoard *board) {
+  // range check first: board_masks_build() shifts by the cell value
+  for (int i = 0; i < CELL_COUNT; i++) {
+    if (board->cells[i] < V_1 || board->cells[i] > V_9) {
+      return false;
+    }
+  }
+  BoardMasks masks;
+  board_masks_build(&masks, board);
+  for (int n = 0; n < ROWS; n++) {
+    if (masks.row_used[n] != ALL_VALUES || masks.col_used[n] != ALL_VALUES || masks.box_used[n] != ALL_VALUES) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Places a value (V_None clears the cell) and keeps the masks up to date
+static inline void board_set(PackedBoard *board, BoardMasks *masks, int i, int val) {
+  int row = cell_row[i], col = cell_col[i], box = cell_box[i];
+  int old = board->cells[i];
+  if (old != V_None) {
+    uint16_t clear = (uint16_t)~VALUE_BIT(old);
+    masks->row_used[row] &= clear;
+    masks->col_used[col] &= clear;
+    masks->box_used[box] &= clear;
+  }
+  board->cells[i] = (uint8_t)val;
+  if (val != V_None) {
+    masks->row_used[row] |= VALUE_BIT(val);
+    masks->col_used[col] |= VALUE_BIT(val);
+    masks->box_used[box] |= VALUE_BIT(val);
+  }
+}
+
+// Values not yet used by the row, column or box of cell i, one bit per value
+static inline unsigned int board_candidates(const BoardMasks *masks, int i) {
+  STAT_ADD(mask_evaluations, 1);
+  return ~(masks->row_used[cell_row[i]] | masks->col_used[cell_col[i]] | masks->box_used[cell_box[i]]) & ALL_VALUES;
+}
+
+// Checks if a value is valid at a given (Sudoku rules)
+bool is_valid(const PackedBoard *board, const BoardMasks *masks, int row, int col, CellValue val) {
+  // A cell's own value never conflicts with itself (placed values are never duplicated)
+  if (board->cells[row * COLS + col] == val) {
+    return true;
+  }
+  return (board_candidates(masks, row * COLS + col) & VALUE_BIT(val)) != 0;
+}
+
+// --- Candidate Kernel ---
+// Candidates of all 81 cells at once, one 16-bit lane per cell: OR the row, column
+// and box masks, invert and popcount. A row is 8 lanes plus the ninth cell in scalar.
+// The instruction set is picked at build time (see the simd option in premake5.lua).
+
+#if defined(SUDOKU_SIMD_AVX2) && defined(__AVX2__)
+#define CANDIDATES_AVX2
+#elif (defined(SUDOKU_SIMD_SSE4) || defined(SUDOKU_SIMD_AVX2)) && (defined(__SSE4_1__) || defined(_MSC_VER)) && \
+      (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+#define CANDIDATES_SSE4
+#elif defined(SUDOKU_SIMD_NEON) && (defined(__ARM_NEON) || defined(_M_ARM64))
+#define CANDIDATES_NEON
+#endif
+
+#if defined(CANDIDATES_AVX2) || defined(CANDIDATES_SSE4)
+#include <immintrin.h>
+
+// Empty cells as 0xFFFF lanes, from 8 cell bytes
+static inline __m128i empty_lanes_sse(const uint8_t *cells) {
+  __m128i values = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)cells));
+  return _mm_cmpeq_epi16(values, _mm_setzero_si128());
+}
+
+// 16-bit popcount via a nibble lookup table
+static inline __m128i popcount16_sse(__m128i v) {
+  const __m128i lut = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m128i nibble = _mm_set1_epi8(0x0F);
+  __m128i bytes = _mm_add_epi8(_mm_shuffle_epi8(lut, _mm_and_si128(v, nibble)),
+                               _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), nibble)));
+  return _mm_add_epi16(_mm_and_si128(bytes, _mm_set1_epi16(0xFF)), _mm_srli_epi16(bytes, 8));
+}
+
+// Box masks of lanes 0..7 of row r
+static inline __m128i band_boxes_sse(const BoardMasks *masks, int r) {
+  const uint16_t *box = &masks->box_used[cell_box[r * COLS]];
+  return _mm_setr_epi16(box[0], box[0], box[0], box[1], box[1], box[1], box[2], box[2]);
+}
+#endif
+
+#if defined(CANDIDATES_AVX2)
+static inline __m256i popcount16_avx2(__m256i v) {
+  const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                       0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i nibble = _mm256_set1_epi8(0x0F);
+  __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lut, _mm256_and_si256(v, nibble)),
+                                  _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble)));
+  return _mm256_add_epi16(_mm256_and_si256(bytes, _mm256_set1_epi16(0xFF)), _mm256_srli_epi16(bytes, 8));
+}
+#endif
+
+#if defined(CANDIDATES_SSE4) || defined(CANDIDATES_AVX2)
+// Lanes 0..7 of row r with 128-bit vectors
+static inline void candidates_row_sse(const PackedBoard *board, const BoardMasks *masks, CandidateGrid *out, int r) {
+  __m128i used = _mm_or_si128(_mm_set1_epi16((short)masks->row_used[r]),
+                              _mm_or_si128(_mm_loadu_si128((const __m128i *)masks->col_used), band_boxes_sse(masks, r)));
+  __m128i empty = empty_lanes_sse(&board->cells[r * COLS]);
+  __m128i mask = _mm_and_si128(_mm_andnot_si128(used, _mm_set1_epi16(ALL_VALUES)), empty);
+  __m128i count = _mm_or_si128(popcount16_sse(mask), _mm_andnot_si128(empty, _mm_set1_epi16(CANDIDATES_FILLED)));
+  _mm_storeu_si128((__m128i *)&out->mask[r * COLS], mask);
+  _mm_storeu_si128((__m128i *)&out->count[r * COLS], count);
+}
+#endif
+
+#if defined(CANDIDATES_NEON)
+#include <arm_neon.h>
+
+static inline void candidates_row_neon(const PackedBoard *board, const BoardMasks *masks, CandidateGrid *out, int r) {
+  const uint16_t *box = &masks->box_used[cell_box[r * COLS]];
+  const uint16_t boxes[8] = {box[0], box[0], box[0], box[1], box[1], box[1], box[2], box[2]};
+  uint16x8_t used = vorrq_u16(vdupq_n_u16(masks->row_used[r]), vorrq_u16(vld1q_u16(masks->col_used), vld1q_u16(boxes)));
+  uint16x8_t empty = vceqq_u16(vmovl_u8(vld1_u8(&board->cells[r * COLS])), vdupq_n_u16(0));
+  uint16x8_t mask = vandq_u16(vbicq_u16(vdupq_n_u16(ALL_VALUES), used), empty);
+  uint16x8_t count = vpaddlq_u8(vcntq_u8(vreinterpretq_u8_u16(mask)));
+  count = vorrq_u16(count, vbicq_u16(vdupq_n_u16(CANDIDATES_FILLED), empty));
+  vst1q_u16(&out->mask[r * COLS], mask);
+  vst1q_u16(&out->count[r * COLS], count);
+}
+#endif
+
+void board_candidates_all(const PackedBoard *board, const BoardMasks *masks, CandidateGrid *out) {
+  STAT_ADD(mask_evaluations, CELL_COUNT);
+#if defined(CANDIDATES_AVX2)
+  // two rows per 256-bit vector, the last row on its own
+  for (int r = 0; r + 1 < ROWS; r += 2) {
+    __m256i row = _mm256_setr_m128i(_mm_set1_epi16((short)masks->row_used[r]), _mm_set1_epi16((short)masks->row_used[r + 1]));
+    __m256i col = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)masks->col_used));
+    __m256i box = _mm256_setr_m128i(band_boxes_sse(masks, r), band_boxes_sse(masks, r + 1));
+    __m256i empty = _mm256_setr_m128i(empty_lanes_sse(&board->cells[r * COLS]), empty_lanes_sse(&board->cells[(r + 1) * COLS]));
+    __m256i used = _mm256_or_si256(row, _mm256_or_si256(col, box));
+    __m256i mask = _mm256_and_si256(_mm256_andnot_si256(used, _mm256_set1_epi16(ALL_VALUES)), empty);
+    __m256i count = _mm256_or_si256(popcount16_avx2(mask), _mm256_andnot_si256(empty, _mm256_set1_epi16(CANDIDATES_FILLED)));
+    // row r+1 starts at lane 9, so store the halves separately
+    _mm_storeu_si128((__m128i *)&out->mask[r * COLS], _mm256_castsi256_si128(mask));
+    _mm_storeu_si128((__m128i *)&out->count[r * COLS], _mm256_castsi256_si128(count));
+    _mm_storeu_si128((__m128i *)&out->mask[(r + 1) * COLS], _mm256_extracti128_si256(mask, 1));
+    _mm_storeu_si128((__m128i *)&out->count[(r + 1) * COLS], _mm256_extracti128_si256(count, 1));
+  }
+  candidates_row_sse(board, masks, out, ROWS - 1);
+#elif defined(CANDIDATES_SSE4)
+  for (int r = 0; r < ROWS; r++) {
+    candidates_row_sse(board, masks, out, r);
+  }
+#elif defined(CANDIDATES_NEON)
+  for (int r = 0; r < ROWS; r++) {
+    candidates_row_neon(board, masks, out, r);
+  }
+#else
+  for (int i = 0; i < CELL_COUNT; i++) {
+    unsigned int candidates = board->cells[i] == V_None ? board_candidates(masks, i) : 0;
+    out->mask[i] = (uint16_t)candidates;
+    out->count[i] = (uint16_t)(board->cells[i] == V_None ? bit_count(candidates) : CANDIDATES_FILLED);
+  }
+  return;
+#endif
+  // the ninth cell of every row
+  for (int r = 0; r < ROWS; r++) {
+    int i = r * COLS + COLS - 1;
+    unsigned int candidates = board->cells[i] == V_None ? board_candidates(masks, i) : 0;
+    out->mask[i] = (uint16_t)candidates;
+    out->count[i] = (uint16_t)(board->cells[i] == V_None ? bit_count(candidates) : CANDIDATES_FILLED);
+  }
+}
+
+// --- Deduction ---
+
+// Cell k (0..8) of unit u: rows 0..8, columns 9..17, boxes 18..26
+static inline int unit_cell(int u, int k) {
+  return unit_cells[u][k];
+}
+
+// Places naked and hidden singles until none are left, pushing every placed
+// cell onto trail. Returns false if the board turns out to have no solution.
+static bool propagate_singles(PackedBoard *board, BoardMasks *masks, uint8_t *trail, int *trail_len) {
+  bool changed = true;
+  while (changed) {
+    changed = false;
+
+    // naked singles: a cell with a single candidate left
+    CandidateGrid grid;
+    board_candidates_all(board, masks, &grid);
+    for (int i = 0; i < CELL_COUNT; i++) {
+      if (grid.count[i] == 0) {
+        return false;
+      }
+      if (grid.count[i] == 1) {
+        // an earlier single in this pass may have taken the value
+        unsigned int candidates = board_candidates(masks, i) & grid.mask[i];
+        if (candidates == 0) {
+          return false;
+        }
+        board_set(board, masks, i, bit_lowest(candidates) + 1);
+        trail[(*trail_len)++] = (uint8_t)i;
+        changed = true;
+      }
+    }
+    if (changed) {
+      continue;
+    }
+
+    // hidden singles: a value with a single place left in a row, column or box
+    for (int u = 0; u < 3 * ROWS && !changed; u++) {
+      unsigned int once = 0, twice = 0, used = 0;
+      for (int k = 0; k < ROWS; k++) {
+        int i = unit_cell(u, k);
+        if (board->cells[i] != V_None) {
+          used |= VALUE_BIT(board->cells[i]);
+          continue;
+        }
+        unsigned int candidates = board_candidates(masks, i);
+        twice |= once & candidates;
+        once |= candidates;
+      }
+      if ((once | used) != ALL_VALUES) {
+        return false; // some value fits nowhere in this unit
+      }
+      unsigned int hidden = once & ~twice;
+      if (hidden == 0) {
+        continue;
+      }
+      // place one of them and rescan, the others may no longer fit
+      int val = bit_lowest(hidden) + 1;
+      for (int k = 0; k < ROWS; k++) {
+        int i = unit_cell(u, k);
+        if (board->cells[i] == V_None && (board_candidates(masks, i) & VALUE_BIT(val))) {
+          board_set(board, masks, i, val);
+          trail[(*trail_len)++] = (uint8_t)i;
+          break;
+        }
+      }
+      changed = true;
+    }
+  }
+  return true;
+}
+
+// Places val at cell i and drops it from the candidates of the cell's peers
+static void rating_place(PackedBoard *board, uint16_t *candidates, int i, int val) {
+  uint16_t clear = (uint16_t)~VALUE_BIT(val);
+  board->cells[i] = (uint8_t)val;
+  candidates[i] = 0;
+  for (int k = 0; k < PEER_COUNT; k++) {
+    candidates[cell_peers[i][k]] &= clear;
+  }
+}
+
+// Locked candidates: a value confined to one line inside a box (pointing) or to
+// one box inside a line (claiming) can be removed from the rest of the other unit
+static bool rating_locked_candidates(uint16_t *candidates) {
+  bool changed = false;
+  for (int box = 0; box < ROWS; box++) {
+    const uint8_t *box_cells = unit_cells[ROWS + COLS + box];
+    // only the 3 rows and 3 columns crossing the box: those of its cells 0, 4 and 8
+    for (int n = 0; n < 6; n++) {
+      int corner = box_cells[(n < 3 ? n : n - 3) * 4];
+      int line = n < 3 ? cell_row[corner] : ROWS + cell_col[corner];
+      unsigned int inside = 0, box_rest = 0, line_rest = 0;
+      for (int k = 0; k < ROWS; k++) {
+        int i = box_cells[k];
+        bool on_line = line < ROWS ? cell_row[i] == line : cell_col[i] == line - ROWS;
+        if (on_line) {
+          inside |= candidates[i];
+        } else {
+          box_rest |= candidates[i];
+        }
+        int j = unit_cell(line, k);
+        if (cell_box[j] != box) {
+          line_rest |= candidates[j];
+        }
+      }
+      // pointing clears the line outside the box, claiming clears the box outside the line
+      unsigned int pointing = inside & ~box_rest & line_rest;
+      unsigned int claiming = inside & ~line_rest & box_rest;
+      for (int k = 0; k < ROWS && (pointing | claiming); k++) {
+        int j = unit_cell(line, k);
+        if (cell_box[j] != box) {
+          candidates[j] &= (uint16_t)~pointing;
+        }
+        int i = box_cells[k];
+        bool on_line = line < ROWS ? cell_row[i] == line : cell_col[i] == line - ROWS;
+        if (!on_line) {
+          candidates[i] &= (uint16_t)~claiming;
+        }
+      }
+      changed |= (pointing | claiming) != 0;
+    }
+  }
+  return changed;
+}
+
+// Solves the board by hand-style techniques only, easiest first, and records
+// which were needed. Anything left over after that takes guessing.
+PuzzleRating rate_puzzle(const PackedBoard *puzzle) {
+  PuzzleRating rating = {0};
+  PackedBoard board = *puzzle;
+  BoardMasks masks;
+  uint16_t candidates[CELL_COUNT];
+  board_masks_build(&masks, &board);
+  for (int i = 0; i < CELL_COUNT; i++) {
+    candidates[i] = board.cells[i] == V_None ? (uint16_t)board_candidates(&masks, i) : 0;
+  }
+
+  int empty = 0;
+  for (int i = 0; i < CELL_COUNT; i++) {
+    empty += board.cells[i] == V_None;
+  }
+
+  while (empty > 0) {
+    int placed = -1, val = 0;
+    Technique technique = TECHNIQUE_NAKED_SINGLE;
+
+    for (int i = 0; i < CELL_COUNT && placed < 0; i++) {
+      if (board.cells[i] != V_None) {
+        continue;
+      }
+      if (candidates[i] == 0) {
+        rating.hardest = TECHNIQUE_GUESS; // contradiction, only a search can tell
+        return rating;
+      }
+      if ((candidates[i] & (candidates[i] - 1)) == 0) {
+        placed = i;
+        val = bit_lowest(candidates[i]) + 1;
+      }
+    }
+
+    for (int u = 0; u < 3 * ROWS && placed < 0; u++) {
+      unsigned int once = 0, twice = 0;
+      for (int k = 0; k < ROWS; k++) {
+        unsigned int c = candidates[unit_cell(u, k)];
+        twice |= once & c;
+        once |= c;
+      }
+      unsigned int hidden = once & ~twice;
+      if (hidden == 0) {
+        continue;
+      }
+      val = bit_lowest(hidden) + 1;
+      for (int k = 0; k < ROWS; k++) {
+        if (candidates[unit_cell(u, k)] & VALUE_BIT(val)) {
+          placed = unit_cell(u, k);
+          break;
+        }
+      }
+      technique = TECHNIQUE_HIDDEN_SINGLE;
+    }
+
+    if (placed < 0) {
+      if (rating_locked_candidates(candidates)) {
+        rating.steps[TECHNIQUE_LOCKED_CANDIDATES]++;
+        if (rating.hardest < TECHNIQUE_LOCKED_CANDIDATES) {
+          rating.hardest = TECHNIQUE_LOCKED_CANDIDATES;
+        }
+        continue;
+      }
+      rating.hardest = TECHNIQUE_GUESS;
+      rating.steps[TECHNIQUE_GUESS]++;
+      return rating;
+    }
+
+    rating_place(&board, candidates, placed, val);
+    rating.steps[technique]++;
+    if (rating.hardest < technique) {
+      rating.hardest = technique;
+    }
+    empty--;
+  }
+  return rating;
+}
+
+// Naked singles only is easy, anything up to locked candidates medium, guessing hard
+Difficulty rating_difficulty(const PuzzleRating *rating) {
+  switch (rating->hardest) {
+    case TECHNIQUE_NAKED_SINGLE:
+      return DIFFICULTY_EASY;
+    case TECHNIQUE_HIDDEN_SINGLE:
+    case TECHNIQUE_LOCKED_CANDIDATES:
+      return DIFFICULTY_MEDIUM;
+    default:
+      return DIFFICULTY_HARD;
+  }
+}
+
+const char *technique_name(Technique technique) {
+  static const char *names[TECHNIQUE_COUNT] = {"naked single", "hidden single", "locked candidates", "guess"};
+  return names[technique];
+}
+
+// --- Play Hints ---
+
+static inline void hints_mark(PlayHints *hints, int i) {
+  unsigned int candidates = hints->board.cells[i] == V_None ? board_candidates(&hints->masks, i) : 0;
+  if (candidates != hints->candidates[i]) {
+    hints->candidates[i] = (uint16_t)candidates;
+    hints->dirty[i >> 6] |= (uint64_t)1 << (i & 63);
+  }
+}
+
+void hints_init(PlayHints *hints, const PackedBoard *board) {
+  hints->board = *board;
+  board_masks_build(&hints->masks, &hints->board);
+  for (int i = 0; i < CELL_COUNT; i++) {
+    hints->candidates[i] = hints->board.cells[i] == V_None ? (uint16_t)board_candidates(&hints->masks, i) : 0;
+  }
+  hints->dirty[0] = ~(uint64_t)0;
+  hints->dirty[1] = ((uint64_t)1 << (CELL_COUNT - 64)) - 1;
+}
+
+// Only the cell and its 20 peers can change, so only they are recomputed
+void hints_set(PlayHints *hints, int cell, int value) {
+  board_set(&hints->board, &hints->masks, cell, value);
+  hints_mark(hints, cell);
+  for (int k = 0; k < PEER_COUNT; k++) {
+    hints_mark(hints, cell_peers[cell][k]);
+  }
+}
+
+// First naked single, else the first hidden single, from the cached marks: no search
+HintMove hints_next_move(const PlayHints *hints) {
+  for (int i = 0; i < CELL_COUNT; i++) {
+    unsigned int candidates = hints->candidates[i];
+    if (candidates != 0 && (candidates & (candidates - 1)) == 0) {
+      return (HintMove){i, bit_lowest(candidates) + 1, TECHNIQUE_NAKED_SINGLE};
+    }
+  }
+  for (int u = 0; u < 3 * ROWS; u++) {
+    unsigned int once = 0, twice = 0;
+    for (int k = 0; k < ROWS; k++) {
+      unsigned int candidates = hints->candidates[unit_cell(u, k)];
+      twice |= once & candidates;
+      once |= candidates;
+    }
+    unsigned int hidden = once & ~twice;
+    if (hidden == 0) {
+      continue;
+    }
+    int val = bit_lowest(hidden) + 1;
+    for (int k = 0; k < ROWS; k++) {
+      int i = unit_cell(u, k);
+      if (hints->candidates[i] & VALUE_BIT(val)) {
+        return (HintMove){i, val, TECHNIQUE_HIDDEN_SINGLE};
+      }
+    }
+  }
+  return (HintMove){-1, V_None, TECHNIQUE_GUESS};
+}
+
+bool hints_take_dirty(PlayHints *hints, uint64_t dirty[2]) {
+  dirty[0] = hints->dirty[0];
+  dirty[1] = hints->dirty[1];
+  hints->dirty[0] = hints->dirty[1] = 0;
+  return (dirty[0] | dirty[1]) != 0;
+}
+
+// --- Iterative Search ---
+
+// Monotonic clock for search time budgets: wall-clock steps (NTP, manual changes) must
+// not stretch or cut a budget
+uint64_t time_now_ns(void) {
+#if defined(_WIN32)
+  static LARGE_INTEGER frequency;
+  if (frequency.QuadPart == 0) {
+    QueryPerformanceFrequency(&frequency); // fixed at boot, racing first calls store the same value
+  }
+  LARGE_INTEGER counter;
+  QueryPerformanceCounter(&counter);
+  uint64_t ticks = (uint64_t)counter.QuadPart, hz = (uint64_t)frequency.QuadPart;
+  return ticks / hz * 1000000000ull + ticks % hz * 1000000000ull / hz;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// Picks the cell to branch on next: -1 = board complete, -2 = some cell has no candidates
+static int search_pick_cell(const SearchTask *task, unsigned int *candidates_out) {
+    if (!(task->flags & SEARCH_MRV)) {
+        // row-major: first empty cell
+        for (int i = 0; i < CELL_COUNT; i++) {
+            if (task->board.cells[i] == V_None) {
+                *candidates_out = board_candidates(&task->masks, i);
+                return *candidates_out ? i : -2;
+            }
+        }
+        return -1;
+    }
+
+    CandidateGrid grid;
+    board_candidates_all(&task->board, &task->masks, &grid);
+    int best = -1;
+    int best_count = CANDIDATES_FILLED;
+    for (int i = 0; i < CELL_COUNT && best_count > 1; i++) {
+        if (grid.count[i] < best_count) {
+            best = i;
+            best_count = grid.count[i];
+        }
+    }
+    if (best < 0) {
+        return -1;
+    }
+    if (best_count == 0) {
+        return -2; // dead end: nothing fits here
+    }
+    *candidates_out = grid.mask[best];
+    return best;
+}
+
+static void search_push(SearchTask *task, int cell, unsigned int candidates) {
+    task->stack[task->depth].cell = (uint8_t)cell;
+    task->stack[task->depth].trail_mark = (uint8_t)task->trail_len;
+    task->stack[task->depth].candidates = (uint16_t)candidates;
+    task->depth++;
+}
+
+// Branch on the chosen cell, or record a solution / dead end for the caller
+static void search_descend(SearchTask *task) {
+    if ((task->flags & SEARCH_DEDUCE) &&
+        !propagate_singles(&task->board, &task->masks, task->trail, &task->trail_len)) {
+        return; // dead end, the caller's frame undoes the partial deductions
+    }
+    unsigned int candidates = 0;
+    int cell = search_pick_cell(task, &candidates);
+    if (cell >= 0) {
+        search_push(task, cell, candidates);
+    } else if (cell == -1) {
+        task->solutions++;
+        if (task->solutions >= task->limit) {
+            task->status = SEARCH_DONE; // the last solution stays on task->board
+        }
+    }
+}
+
+static void search_reset(SearchTask *task, const PackedBoard *board, int limit, unsigned int flags, Rng *rng) {
+    task->board = *board;
+    board_masks_build(&task->masks, &task->board);
+    task->depth = 0;
+    task->trail_len = 0;
+    task->limit = limit;
+    task->solutions = 0;
+    task->nodes = 0;
+    task->flags = flags;
+    task->rng = rng;
+    task->status = SEARCH_RUNNING;
+}
+
+void search_init(SearchTask *task, const PackedBoard *board, int limit, unsigned int flags, Rng *rng) {
+    search_reset(task, board, limit, flags, rng);
+    search_descend(task);
+    if (task->depth == 0) {
+        task->status = SEARCH_DONE; // already complete or already stuck
+    }
+}
+
+// Runs until the search is done or a budget runs out (0 = no limit); call again to resume
+SearchStatus search_run(SearchTask *task, uint64_t node_budget, uint64_t time_budget_ns) {
+    uint64_t node_end = node_budget ? task->nodes + node_budget : UINT64_MAX;
+    uint64_t time_end = time_budget_ns ? time_now_ns() + time_budget_ns : 0;
+
+    while (task->status == SEARCH_RUNNING) {
+        if (task->depth == 0) {
+            task->status = SEARCH_DONE; // search space exhausted
+            break;
+        }
+        if (task->nodes >= node_end ||
+            (time_end && (task->nodes & 1023) == 0 && time_now_ns() >= time_end)) {
+            return SEARCH_PAUSED;
+        }
+
+        SearchFrame *top = &task->stack[task->depth - 1];
+        // Backtrack: reset the value this frame placed last time round, and what followed from it
+        while (task->trail_len > top->trail_mark) {
+            board_set(&task->board, &task->masks, task->trail[--task->trail_len], V_None);
+        }
+        if (top->candidates == 0) {
+            task->depth--;
+            STAT_ADD(backtracks, 1);
+            continue;
+        }
+
+        unsigned int pick = top->candidates;
+        if (task->rng != NULL) {
+            // pick the k-th remaining candidate bit
+            for (int k = rng_below(task->rng, bit_count(pick)); k > 0; k--) {
+                pick &= pick - 1;
+            }
+        }
+        pick &= ~pick + 1;
+        top->candidates &= ~pick;
+
+        board_set(&task->board, &task->masks, top->cell, bit_lowest(pick) + 1);
+        task->trail[task->trail_len++] = top->cell;
+        task->nodes++;
+        STAT_ADD(nodes, 1);
+        search_descend(task);
+    }
+    return task->status;
+}
+
+// --- Pattern Fill ---
+
+// Essentially different solved grids the transform fill starts from (random fill_grid() output)
+static const char *fill_seed_grids[] = {
+  "817643259435982671269571348924156837356827914781394526173269485648735192592418763",
+  "647129538598463712312758496186934275453672981279815364824391657961547823735286149",
+  "591238467268174359743596182376459218984712635152863794425381976617925843839647521",
+  "724691538891453276365278941489312765572946813613587492157864329936725184248139657",
+  "168425397539178462724639851687291543241853976395746128973582614812964735456317289",
+  "269578314485321697731649825827934561694185732513762489956817243372496158148253976",
+  "495816732827493516613752849731985264954621387268347195582169473176234958349578621",
+  "539872614478631952162594783847126395925347861613985427254768139381459276796213548",
+};
+#define FILL_SEED_COUNT ((int)(sizeof(fill_seed_grids) / sizeof(fill_seed_grids[0])))
+
+static void shuffle_small(Rng *rng, uint8_t *items, int count) {
+  for (int i = count - 1; i > 0; i--) {
+    int j = rng_below(rng, i + 1);
+    uint8_t tmp = items[i];
+    items[i] = items[j];
+    items[j] = tmp;
+  }
+}
+
+// Random line order that keeps every line inside a band (or stack): bands are shuffled,
+// then the three lines of each band
+static void shuffle_lines(Rng *rng, uint8_t *lines) {
+  uint8_t bands[3] = {0, 1, 2};
+  shuffle_small(rng, bands, 3);
+  for (int b = 0; b < 3; b++) {
+    uint8_t inner[3] = {0, 1, 2};
+    shuffle_small(rng, inner, 3);
+    for (int k = 0; k < 3; k++) {
+      lines[b * 3 + k] = (uint8_t)(bands[b] * 3 + inner[k]);
+    }
+  }
+}
+
+// Solved grid in constant time: a seed grid put through random validity-preserving
+// transforms (digit relabeling, row/column swaps within bands and stacks, band/stack
+// swaps, transpose). Fast, but only reaches the orbits of the seed grids.
+void fill_grid_transform(Rng *rng, PackedBoard *board) {
+  const char *seed = fill_seed_grids[rng_below(rng, FILL_SEED_COUNT)];
+  uint8_t relabel[9] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+  uint8_t rows[ROWS], cols[COLS];
+  shuffle_small(rng, relabel, 9);
+  shuffle_lines(rng, rows);
+  shuffle_lines(rng, cols);
+  bool transpose = rng_below(rng, 2) != 0;
+
+  for (int r = 0; r < ROWS; r++) {
+    for (int c = 0; c < COLS; c++) {
+      int src = transpose ? cols[c] * COLS + rows[r] : rows[r] * COLS + cols[c];
+      board->cells[r * COLS + c] = relabel[seed[src] - '1'];
+    }
+  }
+}
+
+// Sudoku solver (Generate/Fills in the complete & valid solution into an empty board)
+// FILL_TRANSFORM skips the search and overwrites the whole board
+bool fill_grid(GeneratorContext *ctx, PackedBoard *board) {
+    if (ctx->fill == FILL_TRANSFORM) {
+        fill_grid_transform(&ctx->rng, board);
+        return true;
+    }
+    // row-major with candidates tried in random order, to randomize the puzzle
+    SearchTask task;
+    search_init(&task, board, 1, 0, &ctx->rng);
+    search_run(&task, 0, 0);
+    if (task.solutions == 0) {
+        return false;
+    }
+    memcpy(board->cells, task.board.cells, sizeof(board->cells));
+    return true;
+}
+
+// Counts the number of solutions and stop once limit are found
+// (singles are filled in before every branch, so easy boards never branch)
+int count_solutions(PackedBoard *board, int limit) {
+    SearchTask task;
+    search_init(&task, board, limit, SEARCH_DEDUCE, NULL);
+    search_run(&task, 0, 0);
+    return task.solutions;
+}
+
+// Counts solutions like count_solutions(), but always branches on the empty cell
+// with the fewest candidates (MRV) and gives up as soon as a cell has none
+int count_solutions_mrv(PackedBoard *board, int limit) {
+    SearchTask task;
+    search_init(&task, board, limit, SEARCH_MRV | SEARCH_DEDUCE, NULL);
+    search_run(&task, 0, 0);
+    return task.solutions;
+}
+
+// Counts solutions up to limit like count_solutions_mrv() and copies the first one found
+// to solution (cells only), e.g. to solve and check uniqueness in one search
+int solve_board(const PackedBoard *board, int limit, PackedBoard *solution) {
+    SearchTask task;
+    search_init(&task, board, 1, SEARCH_MRV | SEARCH_DEDUCE, NULL);
+    search_run(&task, 0, 0);
+    if (task.solutions == 1) {
+        memcpy(solution->cells, task.board.cells, sizeof(solution->cells));
+        // the first solution stopped the search, carry on from there for the rest
+        task.limit = limit;
+        task.status = task.solutions < limit ? SEARCH_RUNNING : SEARCH_DONE;
+        search_run(&task, 0, 0);
+    }
+    return task.solutions;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(p) __builtin_prefetch(p)
+#else
+#define PREFETCH(p) ((void)0)
+#endif
+
+// One in-flight search of solve_batch(), run like solve_board()
+typedef struct {
+    SearchTask task;
+    int board;      // input index, -1 = idle
+    bool resumed;   // first solution copied, now counting to the real limit
+} BatchLane;
+
+static void batch_lane_start(BatchLane *lane, const PackedBoard *boards, int board) {
+    lane->board = board;
+    lane->resumed = false;
+    search_init(&lane->task, &boards[board], 1, SEARCH_MRV | SEARCH_DEDUCE, NULL);
+}
+
+// solve_board() over many boards: up to SOLVE_BATCH_LANES searches run round-robin,
+// SOLVE_BATCH_SLICE nodes at a time, and a finished lane takes the next board, so a hard
+// board never holds up the easy ones behind it. Lane state stays in L1 either way; only
+// the next input board is cold, and it is prefetched while the lanes run.
+// solutions[k] gets the count for boards[k] (up to limit), first_solutions[k] (optional)
+// its first solution's cells.
+void solve_batch(const PackedBoard *boards, int count, int limit, int *solutions, PackedBoard *first_solutions) {
+    BatchLane lanes[SOLVE_BATCH_LANES];
+    int lane_count = count < SOLVE_BATCH_LANES ? count : SOLVE_BATCH_LANES;
+    int next = 0, active = 0;
+    for (int l = 0; l < lane_count; l++) {
+        batch_lane_start(&lanes[l], boards, next++);
+        active++;
+    }
+
+    while (active > 0) {
+        if (next < count) {
+            PREFETCH(&boards[next]);
+        }
+        for (int l = 0; l < lane_count; l++) {
+            BatchLane *lane = &lanes[l];
+            if (lane->board < 0 || search_run(&lane->task, SOLVE_BATCH_SLICE, 0) == SEARCH_PAUSED) {
+                continue;
+            }
+            SearchTask *task = &lane->task;
+            if (!lane->resumed && task->solutions == 1 && limit > 1) {
+                if (first_solutions != NULL) {
+                    memcpy(first_solutions[lane->board].cells, task->board.cells, sizeof(task->board.cells));
+                }
+                lane->resumed = true;
+                task->limit = limit;
+                task->status = SEARCH_RUNNING;
+                continue;
+            }
+            if (!lane->resumed && task->solutions == 1 && first_solutions != NULL) {
+                memcpy(first_solutions[lane->board].cells, task->board.cells, sizeof(task->board.cells));
+            }
+            solutions[lane->board] = task->solutions;
+            if (next < count) {
+                batch_lane_start(lane, boards, next++);
+            } else {
+                lane->board = -1;
+                active--;
+            }
+        }
+    }
+}
+
+// Looks for a solution of the board in which cell i holds anything but value
+// (cell i is treated as empty). If the board minus cell i is known to have
+// exactly one solution with value at i, finding none proves it is still unique.
+// The board is not modified; out (optional) receives the differing solution.
+bool find_solution_differing_at(const PackedBoard *board, int i, int value, PackedBoard *out) {
+    PackedBoard start = *board;
+    start.cells[i] = V_None;
+
+    SearchTask task;
+    search_reset(&task, &start, 1, SEARCH_MRV | SEARCH_DEDUCE, NULL);
+    // branch on cell i first, without the known value
+    search_push(&task, i, board_candidates(&task.masks, i) & ~VALUE_BIT(value));
+    search_run(&task, 0, 0);
+    if (task.solutions == 0) {
+        return false;
+    }
+    if (out != NULL) {
+        *out = task.board;
+    }
+    return true;
+}
+
+// --- DLX Solver ---
+// Sudoku as exact cover: 324 constraint columns (cell filled, row/col/box has value)
+// and 729 candidate rows (cell, value), each row covering exactly 4 columns
+#define DLX_COLUMNS 324
+#define DLX_ROWS 729
+#define DLX_NODES (1 + DLX_COLUMNS + DLX_ROWS * 4) // root + column headers + row nodes
+
+typedef struct {
+  int left[DLX_NODES], right[DLX_NODES], up[DLX_NODES], down[DLX_NODES];
+  int column[DLX_NODES];      // column header of each node
+  int size[1 + DLX_COLUMNS];  // rows still linked into each column
+  int row_start[DLX_ROWS];    // first node of each candidate row
+  bool built;
+} DlxSolver;
+
+// Preallocated node arena, one per thread: built once, searching never allocates
+static THREAD_LOCAL DlxSolver dlx_solver;
+
+static void dlx_build(DlxSolver *dlx) {
+  // root (0) and column headers (1..324) form one circular list
+  for (int c = 0; c <= DLX_COLUMNS; c++) {
+    dlx->left[c] = (c == 0) ? DLX_COLUMNS : c - 1;
+    dlx->right[c] = (c == DLX_COLUMNS) ? 0 : c + 1;
+    dlx->up[c] = c;
+    dlx->down[c] = c;
+    dlx->column[c] = c;
+    dlx->size[c] = 0;
+  }
+
+  int node = DLX_COLUMNS + 1;
+  for (int r = 0; r < DLX_ROWS; r++) {
+    int cell = r / 9, v = r % 9;
+    int columns[4] = {
+      1 + cell,
+      1 + 81 + cell_row[cell] * 9 + v,
+      1 + 162 + cell_col[cell] * 9 + v,
+      1 + 243 + cell_box[cell] * 9 + v
+    };
+    dlx->row_start[r] = node;
+    for (int k = 0; k < 4; k++, node++) {
+      int c = columns[k];
+      dlx->column[node] = c;
+      // append to the bottom of column c
+      dlx->up[node] = dlx->up[c];
+      dlx->down[node] = c;
+      dlx->down[dlx->up[c]] = node;
+      dlx->up[c] = node;
+      dlx->size[c]++;
+      // link into the row's circular list
+      dlx->left[node] = (k == 0) ? node + 3 : node - 1;
+      dlx->right[node] = (k == 3) ? node - 3 : node + 1;
+    }
+  }
+  dlx->built = true;
+}
+
+static void dlx_cover(DlxSolver *dlx, int c) {
+  dlx->right[dlx->left[c]] = dlx->right[c];
+  dlx->left[dlx->right[c]] = dlx->left[c];
+  for (int i = dlx->down[c]; i != c; i = dlx->down[i]) {
+    for (int j = dlx->right[i]; j != i; j = dlx->right[j]) {
+      dlx->down[dlx->up[j]] = dlx->down[j];
+      dlx->up[dlx->down[j]] = dlx->up[j];
+      dlx->size[dlx->column[j]]--;
+    }
+  }
+}
+
+static void dlx_uncover(DlxSolver *dlx, int c) {
+  for (int i = dlx->up[c]; i != c; i = dlx->up[i]) {
+    for (int j = dlx->left[i]; j != i; j = dlx->left[j]) {
+      dlx->size[dlx->column[j]]++;
+      dlx->down[dlx->up[j]] = j;
+      dlx->up[dlx->down[j]] = j;
+    }
+  }
+  dlx->right[dlx->left[c]] = c;
+  dlx->left[dlx->right[c]] = c;
+}
+
+// A covered header is no longer pointed back to by its old neighbour
+static inline bool dlx_is_covered(const DlxSolver *dlx, int c) {
+  return dlx->right[dlx->left[c]] != c;
+}
+
+// Algorithm X: counts exact covers of the remaining columns, up to limit
+static int dlx_search(DlxSolver *dlx, int limit) {
+  if (dlx->right[0] == 0) {
+    return 1; // every constraint satisfied
+  }
+
+  // branch on the column with the fewest rows
+  int best = dlx->right[0];
+  for (int c = dlx->right[best]; c != 0; c = dlx->right[c]) {
+    if (dlx->size[c] < dlx->size[best]) {
+      best = c;
+    }
+  }
+  if (dlx->size[best] == 0) {
+    return 0;
+  }
+
+  int solutions_found = 0;
+  dlx_cover(dlx, best);
+  for (int r = dlx->down[best]; r != best && solutions_found < limit; r = dlx->down[r]) {
+    STAT_ADD(nodes, 1);
+    for (int j = dlx->right[r]; j != r; j = dlx->right[j]) {
+      dlx_cover(dlx, dlx->column[j]);
+    }
+    solutions_found += dlx_search(dlx, limit - solutions_found);
+    for (int j = dlx->left[r]; j != r; j = dlx->left[j]) {
+      dlx_uncover(dlx, dlx->column[j]);
+    }
+  }
+  dlx_uncover(dlx, best);
+  if (solutions_found == 0) {
+    STAT_ADD(backtracks, 1);
+  }
+  return solutions_found;
+}
+
+// Counts solutions (up to limit) with Dancing Links; the board is left untouched
+int count_solutions_dlx(PackedBoard *board, int limit) {
+  DlxSolver *dlx = &dlx_solver;
+  if (!dlx->built) {
+    dlx_build(dlx);
+  }
+
+  // Select the rows of the given clues, remembering them so the matrix can be restored
+  int given_rows[CELL_COUNT];
+  int given_count = 0;
+  bool conflict = false;
+  for (int i = 0; i < CELL_COUNT && !conflict; i++) {
+    int val = board->cells[i];
+    if (val == V_None) {
+      continue;
+    }
+    int start = dlx->row_start[i * 9 + (val - 1)];
+    for (int k = 0; k < 4; k++) {
+      if (dlx_is_covered(dlx, dlx->column[start + k])) {
+        conflict = true; // two clues claim the same constraint
+      }
+    }
+    if (!conflict) {
+      for (int k = 0; k < 4; k++) {
+        dlx_cover(dlx, dlx->column[start + k]);
+      }
+      given_rows[given_count++] = start;
+    }
+  }
+
+  int solutions_found = conflict ? 0 : dlx_search(dlx, limit);
+
+  while (given_count > 0) {
+    int start = given_rows[--given_count];
+    for (int k = 3; k >= 0; k--) {
+      dlx_uncover(dlx, dlx->column[start + k]);
+    }
+  }
+  return solutions_found;
+}
+
+// Solution counters selectable through solver_strategy
+static const SolverFn solver_backends[] = {
+  [SOLVER_BACKTRACK] = count_solutions,
+  [SOLVER_MRV] = count_solutions_mrv,
+  [SOLVER_DLX] = count_solutions_dlx
+};
+
+// Checks for a unique solution
+bool has_unique_solution(PackedBoard *board) {
+    // Solved in place: every backend undoes its own placements before returning,
+    // so the board comes back unchanged and no copy is needed
+    int num_solutions = solver_backends[solver_strategy](board, 2); 
+    return num_solutions == 1; 
+}
+
+// Removes cells from a solved Sudoku grid to create a puzzle
+// Walks a shuffled permutation of the cells and tries each one at most once, so
+// there are at most CELL_COUNT uniqueness checks; returns how many were removed
+// (less than count when the board runs out of removable cells)
+int remove_cells(GeneratorContext *ctx, PackedBoard *puzzle, const PackedBoard *solution, int count) {
+    SolverFn count_fn = solver_backends[ctx->strategy];
+
+    // symmetric mode only walks the first half: cell i is paired with CELL_COUNT - 1 - i
+    int order_count = ctx->symmetric ? (CELL_COUNT + 1) / 2 : CELL_COUNT;
+    uint8_t order[CELL_COUNT];
+    for (int i = 0; i < order_count; i++) {
+        order[i] = (uint8_t)i;
+    }
+    for (int i = order_count - 1; i > 0; i--) {
+        int j = rng_below(&ctx->rng, i + 1);
+        uint8_t tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+
+    int removed_count = 0;
+    for (int n = 0; n < order_count && removed_count < count; n++) {
+        int idx = order[n];
+        int mirror = ctx->symmetric ? CELL_COUNT - 1 - idx : idx;
+        int cells = (mirror == idx) ? 1 : 2;
+
+        if (puzzle->cells[idx] == V_None || removed_count + cells > count) { 
+            continue; 
+        }
+
+        // Temporarily remove the value(s) (set to V_None)
+        puzzle->cells[idx] = V_None;
+        puzzle->cells[mirror] = V_None;
+
+        // check against the 'puzzle' (which has values removed) but it still needs to be a valid and solvable state.
+        bool unique;
+        if (ctx->incremental) {
+            // The puzzle was unique before, so any other solution must differ at a removed cell:
+            // either at idx, or (same value at idx) at mirror
+            unique = !find_solution_differing_at(puzzle, idx, solution->cells[idx], NULL);
+            if (unique && mirror != idx) {
+                puzzle->cells[idx] = solution->cells[idx];
+                unique = !find_solution_differing_at(puzzle, mirror, solution->cells[mirror], NULL);
+                puzzle->cells[idx] = V_None;
+            }
+        } else {
+            unique = count_fn(puzzle, 2) == 1;
+        }
+        if (!unique) {
+            // If it leads to multiple solutions or no solution, restore the cell(s)
+            puzzle->cells[idx] = solution->cells[idx];
+            puzzle->cells[mirror] = solution->cells[mirror];
+            STAT_ADD(removals_rejected, 1);
+        } else {
+            removed_count += cells;
+            STAT_ADD(removals_accepted, 1);
+        }
+    }
+
+    // What is left are the FIXED clues, removed cells become DYNAMIC (user input)
+    for (int i = 0; i < CELL_COUNT; i++) {
+        board_set_fixed(puzzle, i, puzzle->cells[i] != V_None);
+    }
+    return removed_count;
+}
+
+// Generates a complete solution and a puzzle with a unique solution carved out of it
+// Reentrant: all state lives in ctx and the output boards; returns the cells removed
+int generate_puzzle(GeneratorContext *ctx, PackedBoard *puzzle, PackedBoard *solution, int cells_to_remove) {
+#if defined(SUDOKU_STATS)
+  SolverStats before = solver_stats;
+  uint64_t start_ns = time_now_ns();
+#endif
+  // 1. Generate a complete, solved Sudoku board
+  memset(solution, 0, sizeof(*solution));
+  fill_grid(ctx, solution); // fills 'solution' with a completed and valid solution
+#if defined(SUDOKU_STATS)
+  uint64_t filled_ns = time_now_ns();
+#endif
+
+  // 2. Removing cells from a copy of the solution to create the puzzle
+  *puzzle = *solution;
+  int removed = remove_cells(ctx, puzzle, solution, cells_to_remove);
+
+#if defined(SUDOKU_STATS)
+  // hand this puzzle's share of the thread counters to the caller
+  ctx->stats.nodes = solver_stats.nodes - before.nodes;
+  ctx->stats.backtracks = solver_stats.backtracks - before.backtracks;
+  ctx->stats.mask_evaluations = solver_stats.mask_evaluations - before.mask_evaluations;
+  ctx->stats.removals_accepted = solver_stats.removals_accepted - before.removals_accepted;
+  ctx->stats.removals_rejected = solver_stats.removals_rejected - before.removals_rejected;
+  ctx->stats.fill_ns = filled_ns - start_ns;
+  ctx->stats.dig_ns = time_now_ns() - filled_ns;
+  solver_stats.fill_ns += ctx->stats.fill_ns;
+  solver_stats.dig_ns += ctx->stats.dig_ns;
+#endif
+  return removed;
+}
+
+// --- Rated Generation ---
+
+#define RATED_DIG_STEP 2      // cells removed between ratings while a candidate is too easy
+#define RATED_MIN_CLUES 20    // stop digging a too-easy candidate here, it's not getting harder
+
+// Puts one removed clue (pair, in symmetric mode) back, false if there were none left
+static bool rated_add_clue(GeneratorContext *ctx, PackedBoard *puzzle, const PackedBoard *solution) {
+    int empty[CELL_COUNT], count = 0;
+    for (int i = 0; i < CELL_COUNT; i++) {
+        if (puzzle->cells[i] == V_None) {
+            empty[count++] = i;
+        }
+    }
+    if (count == 0) {
+        return false;
+    }
+    int i = empty[rng_below(&ctx->rng, count)];
+    int mirror = ctx->symmetric ? CELL_COUNT - 1 - i : i;
+    puzzle->cells[i] = solution->cells[i];
+    puzzle->cells[mirror] = solution->cells[mirror];
+    board_set_fixed(puzzle, i, true);
+    board_set_fixed(puzzle, mirror, true);
+    return true;
+}
+
+static int clue_count(const PackedBoard *puzzle) {
+    int clues = 0;
+    for (int i = 0; i < CELL_COUNT; i++) {
+        clues += puzzle->cells[i] != V_None;
+    }
+    return clues;
+}
+
+// Generates until rating_difficulty() of the puzzle is target->band. Each candidate
+// starts at the band's usual cell count, then is dug further while rated too easy or
+// given clues back while too hard; a candidate that overshoots the band, or runs out of
+// removable cells, is dropped at once. When the budget runs out the closest puzzle so
+// far is returned. True if the result is in the band.
+bool generate_rated(GeneratorContext *ctx, const RatedTarget *target, PackedBoard *puzzle, PackedBoard *solution,
+                    PuzzleRating *rating) {
+    uint64_t deadline = target->time_budget_ns ? time_now_ns() + target->time_budget_ns : 0;
+    int best_distance = DIFFICULTY_COUNT;
+    PackedBoard candidate, candidate_solution;
+
+    for (int tried = 0; target->max_candidates == 0 || tried < target->max_candidates; tried++) {
+        generate_puzzle(ctx, &candidate, &candidate_solution, difficulty_cells_removed(target->band));
+        PuzzleRating current = rate_puzzle(&candidate);
+        int first = (int)rating_difficulty(&current) - (int)target->band;
+        int delta = first;
+        // walk towards the band, only while the rating stays on the side it started on
+        while (delta != 0 && (delta < 0) == (first < 0) && (!deadline || time_now_ns() < deadline)) {
+            if (delta < 0) {
+                if (clue_count(&candidate) <= RATED_MIN_CLUES ||
+                    remove_cells(ctx, &candidate, &candidate_solution, RATED_DIG_STEP) == 0) {
+                    break; // minimal and still too easy
+                }
+            } else if (!rated_add_clue(ctx, &candidate, &candidate_solution)) {
+                break;
+            }
+            current = rate_puzzle(&candidate);
+            delta = (int)rating_difficulty(&current) - (int)target->band;
+        }
+
+        int distance = delta < 0 ? -delta : delta;
+        if (distance < best_distance) {
+            best_distance = distance;
+            *puzzle = candidate;
+            *solution = candidate_solution;
+            *rating = current;
+        }
+        if (best_distance == 0 || (deadline && time_now_ns() >= deadline)) {
+            break;
+        }
+    }
+    return best_distance == 0;
+}
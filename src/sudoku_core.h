@@ -0,0 +1,272 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rng.h"
+
+// Sudoku solver/generator core, shared by the game and the headless tools (no raylib)
+
+// --- Config ---
+#define ROWS 9
+#define COLS 9
+#define CELL_COUNT (ROWS * COLS)
+
+// Difficulty settings 
+#define EASY_CELLS_REMOVED 35
+#define MEDIUM_CELLS_REMOVED 45
+#define HARD_CELLS_REMOVED 55
+
+typedef enum {
+  DIFFICULTY_EASY = 0,
+  DIFFICULTY_MEDIUM,
+  DIFFICULTY_HARD,
+  DIFFICULTY_COUNT
+} Difficulty;
+
+// Candidate masks: bit (v - 1) stands for value v
+#define VALUE_BIT(v) (1u << ((v) - 1))
+#define ALL_VALUES 0x1FFu
+
+// --- Types ---
+typedef enum {
+  V_None = 0, // empty cell
+  V_1, V_2, V_3, V_4, V_5, V_6, V_7, V_8, V_9
+} CellValue;
+
+typedef enum {
+  FIXED = 0, // OG puzzle cell (cannot be changed by user)
+  DYNAMIC    // userinput cell (can be changed)
+} CellType;
+
+typedef struct {
+  CellValue value;
+  CellType type;
+} Cell;
+
+typedef struct {
+  size_t rows, cols;
+  Cell *grid; // dynamic array for the grid
+} Sudoku;
+
+// Compact board used by the solver/generator: 104 bytes, i.e. 2 cache lines
+typedef struct {
+  uint8_t cells[CELL_COUNT]; // row-major, 0 = empty, 1..9 = value
+  uint64_t fixed[2];         // bit i set = cell i is a FIXED clue
+} PackedBoard;
+
+// Row/col/box occupancy masks of a PackedBoard, kept in sync by board_set()
+typedef struct {
+  uint16_t row_used[ROWS];
+  uint16_t col_used[COLS];
+  uint16_t box_used[ROWS]; // boxes numbered left to right, top to bottom
+} BoardMasks;
+
+// Backend used for solution counting (uniqueness checks)
+typedef enum {
+  SOLVER_BACKTRACK = 0, // row-major backtracking
+  SOLVER_MRV,           // backtracking on the most constrained cell first
+  SOLVER_DLX,           // Dancing Links exact cover
+  SOLVER_STRATEGY_COUNT
+} SolverStrategy;
+
+typedef int (*SolverFn)(PackedBoard *board, int limit);
+
+extern SolverStrategy solver_strategy; // backend used by has_unique_solution()
+
+// Iterative backtracking search with an explicit stack, so it can be paused and resumed
+typedef enum {
+  SEARCH_RUNNING = 0,
+  SEARCH_PAUSED,   // budget used up, search_run() again to continue
+  SEARCH_DONE      // limit reached or search space exhausted
+} SearchStatus;
+
+// Candidates of every cell, see board_candidates_all(). Padded so a row's lanes
+// 0..7 can be stored as one vector.
+#define CANDIDATES_FILLED 16  // count of a cell that already holds a value
+typedef struct {
+  uint16_t mask[CELL_COUNT + 7];   // candidate bits, 0 for filled cells
+  uint16_t count[CELL_COUNT + 7];  // number of candidates, CANDIDATES_FILLED for filled cells
+} CandidateGrid;
+
+// search_init() flags
+#define SEARCH_MRV 1u     // branch on the most constrained cell instead of the first empty one
+#define SEARCH_DEDUCE 2u  // fill naked/hidden singles at every node before branching
+
+typedef struct {
+  uint8_t cell;         // cell this frame branches on
+  uint8_t trail_mark;   // trail length before this frame's first placement
+  uint16_t candidates;  // values not tried yet
+} SearchFrame;
+
+typedef struct {
+  PackedBoard board;    // working copy, holds the last solution found once the limit is reached
+  BoardMasks masks;
+  SearchFrame stack[CELL_COUNT];
+  int depth;
+  uint8_t trail[CELL_COUNT];  // cells filled since the start, in order, so they can be undone
+  int trail_len;
+  int limit;            // stop after this many solutions
+  int solutions;
+  uint64_t nodes;       // values placed so far
+  unsigned int flags;   // SEARCH_MRV, SEARCH_DEDUCE
+  Rng *rng;             // if set, candidates are tried in random order
+  SearchStatus status;
+} SearchTask;
+
+// solve_batch(): searches kept in flight, and nodes each one runs before the next one's turn
+#define SOLVE_BATCH_LANES 8
+#define SOLVE_BATCH_SLICE 32
+
+// Solving techniques, easiest first
+typedef enum {
+  TECHNIQUE_NAKED_SINGLE = 0,
+  TECHNIQUE_HIDDEN_SINGLE,
+  TECHNIQUE_LOCKED_CANDIDATES,
+  TECHNIQUE_GUESS,             // stuck, only a search gets further
+  TECHNIQUE_COUNT
+} Technique;
+
+typedef struct {
+  Technique hardest;           // hardest technique the puzzle needed
+  int steps[TECHNIQUE_COUNT];  // how often each one was applied
+} PuzzleRating;
+
+// Pencil marks and hints for the board being played, updated one move at a time
+typedef struct {
+  PackedBoard board;                // the player's grid
+  BoardMasks masks;
+  uint16_t candidates[CELL_COUNT];  // pencil marks, 0 for filled cells
+  uint64_t dirty[2];                // bit i set = cell i's marks changed since hints_take_dirty()
+} PlayHints;
+
+typedef struct {
+  int cell;             // -1 if no single is left (locked candidates or a guess needed)
+  int value;
+  Technique technique;  // TECHNIQUE_NAKED_SINGLE or TECHNIQUE_HIDDEN_SINGLE
+} HintMove;
+
+// Solver work counters, only counted when built with SUDOKU_STATS (premake --stats)
+typedef struct {
+  uint64_t nodes;              // values tried by a search (DLX: rows selected)
+  uint64_t backtracks;         // branches exhausted without a solution left to try
+  uint64_t mask_evaluations;   // cell candidate masks computed
+  uint64_t removals_accepted;  // remove_cells() uniqueness checks that passed
+  uint64_t removals_rejected;
+  uint64_t fill_ns;            // generate_puzzle() time spent filling the solution
+  uint64_t dig_ns;             // ... and removing cells
+} SolverStats;
+
+// How generate_puzzle() builds the solved grid
+typedef enum {
+  FILL_BACKTRACK = 0, // randomized search, samples (close to) uniformly from all grids
+  FILL_TRANSFORM      // random transforms of a seed grid, no search at all
+} FillStrategy;
+
+// Everything one generator needs, so several can run on different threads
+typedef struct {
+  Rng rng;                  // random state, never shared between threads
+  SolverStrategy strategy;  // backend for the uniqueness checks, defaults to solver_strategy
+  bool symmetric;           // remove cells in 180-degree rotational pairs
+  bool incremental;         // check removals with find_solution_differing_at() instead of a full count
+  FillStrategy fill;        // defaults to FILL_BACKTRACK
+  SolverStats stats;        // work of the last generate_puzzle(), all zero without SUDOKU_STATS
+} GeneratorContext;
+
+// generate_rated() request: a rating band plus how long to look for it
+typedef struct {
+  Difficulty band;          // wanted rating_difficulty() of the result
+  uint64_t time_budget_ns;  // return the best puzzle so far after this, 0 = no limit
+  int max_candidates;       // solved grids tried at most, 0 = no limit
+} RatedTarget;
+
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+// Counters go to the calling thread's solver_stats; compiled out they cost nothing
+#if defined(SUDOKU_STATS)
+extern THREAD_LOCAL SolverStats solver_stats;
+#define STAT_ADD(field, n) (solver_stats.field += (uint64_t)(n))
+#else
+#define STAT_ADD(field, n) ((void)0)
+#endif
+
+// --- Bit Helpers ---
+#if defined(_MSC_VER)
+#include <intrin.h>
+static inline int bit_count(unsigned int mask) { return (int)__popcnt(mask); }
+static inline int bit_lowest(unsigned int mask) { unsigned long i; _BitScanForward(&i, mask); return (int)i; }
+#else
+static inline int bit_count(unsigned int mask) { return __builtin_popcount(mask); }
+static inline int bit_lowest(unsigned int mask) { return __builtin_ctz(mask); }
+#endif
+
+// --- Packed Board Helpers ---
+static inline bool board_is_fixed(const PackedBoard *board, int i) {
+  return (board->fixed[i >> 6] >> (i & 63)) & 1;
+}
+
+static inline void board_set_fixed(PackedBoard *board, int i, bool fixed) {
+  uint64_t bit = (uint64_t)1 << (i & 63);
+  if (fixed) {
+    board->fixed[i >> 6] |= bit;
+  } else {
+    board->fixed[i >> 6] &= ~bit;
+  }
+}
+// --- Difficulty ---
+int difficulty_cells_removed(Difficulty difficulty);
+const char *difficulty_name(Difficulty difficulty); // "easy", "medium", "hard"
+
+// --- Generator Context ---
+void generator_init(GeneratorContext *ctx, uint64_t seed);
+
+// --- Sudoku Functions ---
+Sudoku game_open(size_t rows, size_t cols);
+void game_close(Sudoku sudoku_instance);
+void grid_fill(Sudoku sudoku_instance, CellValue val, CellType type);
+
+// --- Packed Board ---
+void board_from_sudoku(PackedBoard *board, const Sudoku *sudoku_ptr);
+void board_to_sudoku(Sudoku *sudoku_ptr, const PackedBoard *board);
+void board_masks_build(BoardMasks *masks, const PackedBoard *board);
+bool board_consistent(const PackedBoard *board); // false if a value repeats in a row, column or box
+bool board_solved(const PackedBoard *board);     // every cell filled and every row, column and box complete
+bool is_valid(const PackedBoard *board, const BoardMasks *masks, int row, int col, CellValue val);
+void board_candidates_all(const PackedBoard *board, const BoardMasks *masks, CandidateGrid *out);
+
+// --- Deduction ---
+PuzzleRating rate_puzzle(const PackedBoard *puzzle);
+Difficulty rating_difficulty(const PuzzleRating *rating);
+const char *technique_name(Technique technique);
+
+// --- Play Hints ---
+void hints_init(PlayHints *hints, const PackedBoard *board);           // every cell starts dirty
+void hints_set(PlayHints *hints, int cell, int value);                 // place, or clear with V_None
+HintMove hints_next_move(const PlayHints *hints);
+bool hints_take_dirty(PlayHints *hints, uint64_t dirty[2]);            // false if nothing changed
+
+// --- Solvers ---
+void search_init(SearchTask *task, const PackedBoard *board, int limit, unsigned int flags, Rng *rng);
+SearchStatus search_run(SearchTask *task, uint64_t node_budget, uint64_t time_budget_ns); // 0 = unlimited
+uint64_t time_now_ns(void);
+
+bool fill_grid(GeneratorContext *ctx, PackedBoard *board);
+void fill_grid_transform(Rng *rng, PackedBoard *board);
+int count_solutions(PackedBoard *board, int limit);
+int count_solutions_mrv(PackedBoard *board, int limit);
+int count_solutions_dlx(PackedBoard *board, int limit);
+int solve_board(const PackedBoard *board, int limit, PackedBoard *solution);
+void solve_batch(const PackedBoard *boards, int count, int limit, int *solutions, PackedBoard *first_solutions);
+bool has_unique_solution(PackedBoard *board);
+bool find_solution_differing_at(const PackedBoard *board, int i, int value, PackedBoard *out);
+
+// --- Generator ---
+int remove_cells(GeneratorContext *ctx, PackedBoard *puzzle, const PackedBoard *solution, int count);
+int generate_puzzle(GeneratorContext *ctx, PackedBoard *puzzle, PackedBoard *solution, int cells_to_remove);
+bool generate_rated(GeneratorContext *ctx, const RatedTarget *target, PackedBoard *puzzle, PackedBoard *solution,
+                    PuzzleRating *rating);
@@ -0,0 +1,74 @@
+#include "sudoku_geometry.h"
+
+#include <string.h>
+
+#define GEOMETRY_PASTE_(a, b) a##b
+#define GEOMETRY_PASTE(a, b) GEOMETRY_PASTE_(a, b)
+
+#define GEOMETRY_FILL_ATTEMPTS 64      // restarts before fill_grid_N gives up
+#define GEOMETRY_FILL_BUDGET 16        // nodes per cell for one fill attempt
+#define GEOMETRY_CHECK_BUDGET 2000     // nodes for one uniqueness check
+#define GEOMETRY_MAX_REJECTS 2         // consecutive kept clues (times the side) before giving up
+
+#define GEOMETRY_BOX 2
+#define GEOMETRY_SIZE 4
+#include "sudoku_geometry_template.h"
+#undef GEOMETRY_BOX
+#undef GEOMETRY_SIZE
+
+#define GEOMETRY_BOX 4
+#define GEOMETRY_SIZE 16
+#include "sudoku_geometry_template.h"
+#undef GEOMETRY_BOX
+#undef GEOMETRY_SIZE
+
+#define GEOMETRY_BOX 5
+#define GEOMETRY_SIZE 25
+#include "sudoku_geometry_template.h"
+#undef GEOMETRY_BOX
+#undef GEOMETRY_SIZE
+
+bool geometry_supported(int size) {
+  return size == 4 || size == ROWS || size == 16 || size == 25;
+}
+
+int geometry_cells_removed(int size, Difficulty difficulty) {
+  return difficulty_cells_removed(difficulty) * size * size / CELL_COUNT;
+}
+
+// 9x9 goes through the regular generator with a context borrowing rng
+static int generate_puzzle_9(Rng *rng, uint8_t *puzzle, uint8_t *solution, int cells_to_remove) {
+  GeneratorContext ctx;
+  generator_init(&ctx, 0);
+  ctx.rng = *rng;
+  PackedBoard packed_puzzle, packed_solution;
+  int removed = generate_puzzle(&ctx, &packed_puzzle, &packed_solution, cells_to_remove);
+  *rng = ctx.rng;
+  memcpy(puzzle, packed_puzzle.cells, CELL_COUNT);
+  memcpy(solution, packed_solution.cells, CELL_COUNT);
+  return removed;
+}
+
+int generate_puzzle_sized(int size, Rng *rng, uint8_t *puzzle, uint8_t *solution, int cells_to_remove) {
+  switch (size) {
+    case 4: return generate_puzzle_4(rng, puzzle, solution, cells_to_remove);
+    case 9: return generate_puzzle_9(rng, puzzle, solution, cells_to_remove);
+    case 16: return generate_puzzle_16(rng, puzzle, solution, cells_to_remove);
+    case 25: return generate_puzzle_25(rng, puzzle, solution, cells_to_remove);
+    default: return -1;
+  }
+}
+
+int count_solutions_sized(int size, const uint8_t *cells, int limit) {
+  switch (size) {
+    case 4: return count_solutions_4(cells, limit);
+    case 9: {
+      PackedBoard board = {0};
+      memcpy(board.cells, cells, CELL_COUNT);
+      return count_solutions_mrv(&board, limit);
+    }
+    case 16: return count_solutions_16(cells, limit);
+    case 25: return count_solutions_25(cells, limit);
+    default: return -1;
+  }
+}
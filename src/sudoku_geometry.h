@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rng.h"
+#include "sudoku_core.h"
+
+// Boards other than 9x9: side N = box * box for boxes of 2, 4 and 5 (4x4, 16x16, 25x25).
+// Cells are one byte each, row-major, 0 = empty and 1..N for values. Every size is its
+// own compile-time specialization (see sudoku_geometry_template.h); 9x9 keeps using the
+// PackedBoard solver in sudoku_core.c.
+
+#define GEOMETRY_MAX_SIZE 25
+#define GEOMETRY_MAX_CELLS (GEOMETRY_MAX_SIZE * GEOMETRY_MAX_SIZE)
+
+#define GEOMETRY_DECLARE(n) \
+  bool fill_grid_##n(Rng *rng, uint8_t *cells); \
+  int count_solutions_##n(const uint8_t *cells, int limit); \
+  int generate_puzzle_##n(Rng *rng, uint8_t *puzzle, uint8_t *solution, int cells_to_remove);
+
+GEOMETRY_DECLARE(4)
+GEOMETRY_DECLARE(16)
+GEOMETRY_DECLARE(25)
+
+bool geometry_supported(int size);  // 4, 9, 16 or 25
+int geometry_cells_removed(int size, Difficulty difficulty); // removal count scaled from 9x9
+
+// Picks the specialization for size at runtime. Returns the number of cells removed,
+// -1 for an unsupported size or a failed fill
+int generate_puzzle_sized(int size, Rng *rng, uint8_t *puzzle, uint8_t *solution, int cells_to_remove);
+int count_solutions_sized(int size, const uint8_t *cells, int limit);
@@ -0,0 +1,290 @@
+// Solver and generator for one board geometry. sudoku_geometry.c includes it once per
+// size with GEOMETRY_BOX and GEOMETRY_SIZE (= box * box) defined, so no include guard.
+// Every size gets its own copy with the side, cell count and masks as compile-time
+// constants: unit loops have a fixed trip count and divisions turn into multiplies.
+
+#define G_BOX GEOMETRY_BOX
+#define G_N GEOMETRY_SIZE
+#define G_CELLS (G_N * G_N)
+#define G_ALL ((G_Mask)((1ull << G_N) - 1))
+#define G_NAME(name) GEOMETRY_PASTE(name, G_N)
+
+_Static_assert(G_N == G_BOX * G_BOX, "GEOMETRY_SIZE must be GEOMETRY_BOX squared");
+
+typedef uint32_t G_Mask; // one bit per value, up to 25
+
+typedef struct {
+  uint8_t cells[G_CELLS];  // 0 = empty, 1..N
+  G_Mask row[G_N];
+  G_Mask col[G_N];
+  G_Mask box[G_N];
+} G_NAME(GeoState);
+
+typedef struct {
+  uint16_t cell;
+  uint16_t trail_mark;
+  G_Mask candidates;
+} G_NAME(GeoFrame);
+
+static inline int G_NAME(geo_box)(int i) {
+  int row = i / G_N, col = i % G_N;
+  return (row / G_BOX) * G_BOX + col / G_BOX;
+}
+
+// Cell k of unit u: rows, then columns, then boxes
+static inline int G_NAME(geo_unit_cell)(int u, int k) {
+  if (u < G_N) {
+    return u * G_N + k;
+  }
+  if (u < 2 * G_N) {
+    return k * G_N + (u - G_N);
+  }
+  int box = u - 2 * G_N;
+  return ((box / G_BOX) * G_BOX + k / G_BOX) * G_N + (box % G_BOX) * G_BOX + k % G_BOX;
+}
+
+static inline void G_NAME(geo_set)(G_NAME(GeoState) *state, int i, int val) {
+  int row = i / G_N, col = i % G_N, box = G_NAME(geo_box)(i);
+  if (state->cells[i] != 0) {
+    G_Mask clear = ~((G_Mask)1 << (state->cells[i] - 1));
+    state->row[row] &= clear;
+    state->col[col] &= clear;
+    state->box[box] &= clear;
+  }
+  state->cells[i] = (uint8_t)val;
+  if (val != 0) {
+    G_Mask bit = (G_Mask)1 << (val - 1);
+    state->row[row] |= bit;
+    state->col[col] |= bit;
+    state->box[box] |= bit;
+  }
+}
+
+static inline G_Mask G_NAME(geo_candidates)(const G_NAME(GeoState) *state, int i) {
+  return ~(state->row[i / G_N] | state->col[i % G_N] | state->box[G_NAME(geo_box)(i)]) & G_ALL;
+}
+
+// Returns false if the clues already conflict
+static bool G_NAME(geo_load)(G_NAME(GeoState) *state, const uint8_t *cells) {
+  memset(state, 0, sizeof(*state));
+  for (int i = 0; i < G_CELLS; i++) {
+    if (cells[i] != 0) {
+      if (!(G_NAME(geo_candidates)(state, i) & ((G_Mask)1 << (cells[i] - 1)))) {
+        return false;
+      }
+      G_NAME(geo_set)(state, i, cells[i]);
+    }
+  }
+  return true;
+}
+
+// Naked and hidden singles, like propagate_singles() for 9x9
+static bool G_NAME(geo_propagate)(G_NAME(GeoState) *state, uint16_t *trail, int *trail_len) {
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (int i = 0; i < G_CELLS; i++) {
+      if (state->cells[i] != 0) {
+        continue;
+      }
+      G_Mask candidates = G_NAME(geo_candidates)(state, i);
+      if (candidates == 0) {
+        return false;
+      }
+      if ((candidates & (candidates - 1)) == 0) {
+        G_NAME(geo_set)(state, i, bit_lowest(candidates) + 1);
+        trail[(*trail_len)++] = (uint16_t)i;
+        changed = true;
+      }
+    }
+    if (changed) {
+      continue;
+    }
+    // hidden singles: unlike the 9x9 pass, place every one found in a sweep, a value
+    // that stopped fitting shows up as a contradiction on the next round
+    for (int u = 0; u < 3 * G_N; u++) {
+      G_Mask once = 0, twice = 0, used = 0;
+      for (int k = 0; k < G_N; k++) {
+        int i = G_NAME(geo_unit_cell)(u, k);
+        if (state->cells[i] != 0) {
+          used |= (G_Mask)1 << (state->cells[i] - 1);
+          continue;
+        }
+        G_Mask candidates = G_NAME(geo_candidates)(state, i);
+        twice |= once & candidates;
+        once |= candidates;
+      }
+      if ((once | used) != G_ALL) {
+        return false;
+      }
+      G_Mask hidden = once & ~twice;
+      for (int k = 0; k < G_N && hidden; k++) {
+        int i = G_NAME(geo_unit_cell)(u, k);
+        G_Mask bit = state->cells[i] == 0 ? G_NAME(geo_candidates)(state, i) & hidden : 0;
+        if (bit) {
+          G_NAME(geo_set)(state, i, bit_lowest(bit) + 1);
+          trail[(*trail_len)++] = (uint16_t)i;
+          hidden &= ~bit;
+          changed = true;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Most constrained empty cell: -1 = complete, -2 = dead end
+static int G_NAME(geo_pick_cell)(const G_NAME(GeoState) *state, G_Mask *candidates_out) {
+  int best = -1, best_count = G_N + 1;
+  for (int i = 0; i < G_CELLS && best_count > 1; i++) {
+    if (state->cells[i] != 0) {
+      continue;
+    }
+    G_Mask candidates = G_NAME(geo_candidates)(state, i);
+    int count = bit_count(candidates);
+    if (count == 0) {
+      return -2;
+    }
+    if (count < best_count) {
+      best = i;
+      best_count = count;
+      *candidates_out = candidates;
+    }
+  }
+  return best;
+}
+
+// Explicit-stack MRV search with singles at every node, same scheme as search_run().
+// first_cell >= 0 starts by branching on that cell over first_candidates only.
+// Values are tried in random order when rng is set. Returns the number of solutions
+// found up to limit (the last one is left in state), or -1 if node_budget ran out.
+static int G_NAME(geo_search)(G_NAME(GeoState) *state, int limit, Rng *rng, uint64_t node_budget,
+                              int first_cell, G_Mask first_candidates) {
+  G_NAME(GeoFrame) stack[G_CELLS];
+  uint16_t trail[G_CELLS];
+  int depth = 0, trail_len = 0, solutions = 0;
+  uint64_t nodes = 0;
+
+  if (first_cell >= 0) {
+    stack[depth++] = (G_NAME(GeoFrame)){(uint16_t)first_cell, 0, first_candidates};
+  } else {
+    G_Mask candidates = 0;
+    int cell = G_NAME(geo_propagate)(state, trail, &trail_len) ? G_NAME(geo_pick_cell)(state, &candidates) : -2;
+    if (cell == -1) {
+      return 1;
+    }
+    if (cell == -2) {
+      return 0;
+    }
+    stack[depth++] = (G_NAME(GeoFrame)){(uint16_t)cell, (uint16_t)trail_len, candidates};
+  }
+
+  while (depth > 0) {
+    G_NAME(GeoFrame) *top = &stack[depth - 1];
+    while (trail_len > top->trail_mark) {
+      G_NAME(geo_set)(state, trail[--trail_len], 0);
+    }
+    if (top->candidates == 0) {
+      depth--;
+      continue;
+    }
+    if (node_budget && nodes >= node_budget) {
+      return -1;
+    }
+
+    G_Mask pick = top->candidates;
+    if (rng != NULL) {
+      for (int k = rng_below(rng, bit_count(pick)); k > 0; k--) {
+        pick &= pick - 1;
+      }
+    }
+    pick &= ~pick + 1;
+    top->candidates &= ~pick;
+
+    G_NAME(geo_set)(state, top->cell, bit_lowest(pick) + 1);
+    trail[trail_len++] = top->cell;
+    nodes++;
+
+    G_Mask candidates = 0;
+    int cell = G_NAME(geo_propagate)(state, trail, &trail_len) ? G_NAME(geo_pick_cell)(state, &candidates) : -2;
+    if (cell >= 0) {
+      stack[depth++] = (G_NAME(GeoFrame)){(uint16_t)cell, (uint16_t)trail_len, candidates};
+    } else if (cell == -1 && ++solutions >= limit) {
+      return solutions;
+    }
+  }
+  return solutions;
+}
+
+bool G_NAME(fill_grid_)(Rng *rng, uint8_t *cells) {
+  G_NAME(GeoState) state;
+  // a random fill can wander into a huge dead subtree on big boards, restart instead
+  for (int attempt = 0; attempt < GEOMETRY_FILL_ATTEMPTS; attempt++) {
+    if (!G_NAME(geo_load)(&state, cells)) {
+      return false;
+    }
+    int found = G_NAME(geo_search)(&state, 1, rng, GEOMETRY_FILL_BUDGET * G_CELLS, -1, 0);
+    if (found == 1) {
+      memcpy(cells, state.cells, G_CELLS);
+      return true;
+    }
+    if (found == 0) {
+      return false;
+    }
+  }
+  return false;
+}
+
+int G_NAME(count_solutions_)(const uint8_t *cells, int limit) {
+  G_NAME(GeoState) state;
+  if (!G_NAME(geo_load)(&state, cells)) {
+    return 0;
+  }
+  return G_NAME(geo_search)(&state, limit, NULL, 0, -1, 0);
+}
+
+// Same removal scheme as remove_cells(): random order, each removal checked by
+// searching for a solution in which the cell differs from the known one. A check
+// that exceeds GEOMETRY_CHECK_BUDGET keeps the clue, and a long run of kept clues
+// ends the removal early since the board is close to minimal by then.
+int G_NAME(generate_puzzle_)(Rng *rng, uint8_t *puzzle, uint8_t *solution, int cells_to_remove) {
+  memset(solution, 0, G_CELLS);
+  if (!G_NAME(fill_grid_)(rng, solution)) {
+    return -1;
+  }
+  memcpy(puzzle, solution, G_CELLS);
+
+  uint16_t order[G_CELLS];
+  for (int i = 0; i < G_CELLS; i++) {
+    order[i] = (uint16_t)i;
+  }
+  for (int i = G_CELLS - 1; i > 0; i--) {
+    int j = rng_below(rng, i + 1);
+    uint16_t tmp = order[i];
+    order[i] = order[j];
+    order[j] = tmp;
+  }
+
+  int removed = 0, rejected = 0;
+  G_NAME(GeoState) state;
+  for (int k = 0; k < G_CELLS && removed < cells_to_remove && rejected < GEOMETRY_MAX_REJECTS * G_N; k++) {
+    int i = order[k];
+    puzzle[i] = 0;
+    G_NAME(geo_load)(&state, puzzle);
+    G_Mask others = G_NAME(geo_candidates)(&state, i) & ~((G_Mask)1 << (solution[i] - 1));
+    if (others == 0 || G_NAME(geo_search)(&state, 1, NULL, GEOMETRY_CHECK_BUDGET, i, others) == 0) {
+      removed++;
+      rejected = 0;
+    } else {
+      puzzle[i] = solution[i];
+      rejected++;
+    }
+  }
+  return removed;
+}
+
+#undef G_BOX
+#undef G_N
+#undef G_CELLS
+#undef G_ALL
+#undef G_NAME
@@ -0,0 +1,311 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sudoku_core.h"
+
+// Solver/generator benchmark. Every run uses the same seeds and corpus, so two builds
+// can be compared by diffing the output: one JSON object per line and benchmark with
+// ops, ns/op, nodes/op (where the search exposes them, generate_puzzle needs a
+// SUDOKU_STATS build) and p50/p99 latency
+
+#define DEFAULT_OPS 1000
+#define DEFAULT_SEED 1
+
+typedef struct {
+  const char *group;   // "easy", "hard" or "17-clue"
+  const char *cells;   // 81 chars, '.' for empty
+} CorpusEntry;
+
+// Fixed corpus, every entry has exactly one solution
+static const CorpusEntry corpus[] = {
+  {"easy",    "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79"},
+  {"hard",    "1....7.9..3..2...8..96..5....53..9...1..8...26....4...3......1..4......7..7...3.."}, // AI Escargot
+  {"hard",    "8..........36......7..9.2...5...7.......457.....1...3...1....68..85...1..9....4.."}, // Inkala 2012
+  {"17-clue", ".......1.4.........2...........5.4.7..8...3....1.9....3..4..2...5.1........8.6..."},
+  {"17-clue", "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5..2.....1.4......"},
+  {"17-clue", "52...6.........7.13...........4..8..6......5...........418.........3..2...87....."},
+  {"17-clue", "6.....8.3.4.7.................5.4.7.3..2.....1.6.......2.....5.....8.6......1...."},
+  {"17-clue", "48.3............71.2.......7.5....6....2..8.............1.76...3.....4......5...."},
+};
+#define CORPUS_SIZE ((int)(sizeof(corpus) / sizeof(corpus[0])))
+
+static const char *corpus_groups[] = {"easy", "hard", "17-clue"};
+#define CORPUS_GROUPS ((int)(sizeof(corpus_groups) / sizeof(corpus_groups[0])))
+
+static const char *strategy_names[] = {
+  [SOLVER_BACKTRACK] = "backtrack",
+  [SOLVER_MRV] = "mrv",
+  [SOLVER_DLX] = "dlx",
+};
+
+// Per-op timings of one benchmark
+typedef struct {
+  uint64_t *ns;
+  long ops;
+  uint64_t total_ns;
+  uint64_t nodes;
+  bool has_nodes;
+} Samples;
+
+static void samples_init(Samples *samples, long capacity) {
+  samples->ns = malloc((size_t)capacity * sizeof(uint64_t));
+  if (samples->ns == NULL) {
+    fprintf(stderr, "Error: Failed to allocate memory\n");
+    exit(EXIT_FAILURE);
+  }
+  samples->ops = 0;
+  samples->total_ns = 0;
+  samples->nodes = 0;
+  samples->has_nodes = false;
+}
+
+static void samples_add(Samples *samples, uint64_t start_ns) {
+  uint64_t ns = time_now_ns() - start_ns;
+  samples->ns[samples->ops++] = ns;
+  samples->total_ns += ns;
+}
+
+static int compare_u64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+// Prints one result line and frees the samples
+static void samples_report(Samples *samples, const char *bench, const char *variant) {
+  long n = samples->ops;
+  qsort(samples->ns, (size_t)n, sizeof(uint64_t), compare_u64);
+  printf("{\"bench\":\"%s\",\"variant\":\"%s\",\"ops\":%ld,\"ns_per_op\":%.0f,", bench, variant, n,
+         n ? (double)samples->total_ns / n : 0.0);
+  if (samples->has_nodes) {
+    printf("\"nodes_per_op\":%.1f,", n ? (double)samples->nodes / n : 0.0);
+  } else {
+    printf("\"nodes_per_op\":null,");
+  }
+  printf("\"p50_ns\":%llu,\"p99_ns\":%llu}\n",
+         n ? (unsigned long long)samples->ns[n / 2] : 0ull,
+         n ? (unsigned long long)samples->ns[(n * 99) / 100] : 0ull);
+  free(samples->ns);
+}
+
+static void parse_board(PackedBoard *board, const char *cells) {
+  memset(board, 0, sizeof(*board));
+  for (int i = 0; i < CELL_COUNT; i++) {
+    board->cells[i] = cells[i] >= '1' && cells[i] <= '9' ? (uint8_t)(cells[i] - '0') : V_None;
+    board_set_fixed(board, i, board->cells[i] != V_None);
+  }
+}
+
+static void bench_fill(long ops, uint64_t seed) {
+  Samples samples;
+  samples_init(&samples, ops);
+  samples.has_nodes = true;
+  GeneratorContext ctx;
+  generator_init(&ctx, seed);
+  for (long k = 0; k < ops; k++) {
+    PackedBoard board = {0};
+    // the same search fill_grid() runs, driven directly to read its node count
+    uint64_t start = time_now_ns();
+    SearchTask task;
+    search_init(&task, &board, 1, 0, &ctx.rng);
+    search_run(&task, 0, 0);
+    samples_add(&samples, start);
+    samples.nodes += task.nodes;
+  }
+  samples_report(&samples, "fill_grid", "backtrack");
+
+  samples_init(&samples, ops);
+  for (long k = 0; k < ops; k++) {
+    PackedBoard board;
+    uint64_t start = time_now_ns();
+    fill_grid_transform(&ctx.rng, &board);
+    samples_add(&samples, start);
+  }
+  samples_report(&samples, "fill_grid", "transform");
+}
+
+static void bench_count(long ops) {
+  for (int s = 0; s < SOLVER_STRATEGY_COUNT; s++) {
+    for (int g = 0; g < CORPUS_GROUPS; g++) {
+      Samples samples;
+      samples_init(&samples, ops * CORPUS_SIZE);
+      samples.has_nodes = s != SOLVER_DLX;
+      for (long k = 0; k < ops; k++) {
+        for (int c = 0; c < CORPUS_SIZE; c++) {
+          if (strcmp(corpus[c].group, corpus_groups[g]) != 0) {
+            continue;
+          }
+          PackedBoard board;
+          parse_board(&board, corpus[c].cells);
+          uint64_t start = time_now_ns();
+          if (s == SOLVER_DLX) {
+            count_solutions_dlx(&board, 2);
+          } else {
+            SearchTask task;
+            search_init(&task, &board, 2, (s == SOLVER_MRV ? SEARCH_MRV : 0) | SEARCH_DEDUCE, NULL);
+            search_run(&task, 0, 0);
+            samples.nodes += task.nodes;
+          }
+          samples_add(&samples, start);
+        }
+      }
+      char variant[64];
+      snprintf(variant, sizeof(variant), "%s/%s", strategy_names[s], corpus_groups[g]);
+      samples_report(&samples, "count_solutions", variant);
+    }
+  }
+}
+
+static void bench_unique(long ops, uint64_t seed) {
+  GeneratorContext ctx;
+  generator_init(&ctx, seed);
+  for (int d = 0; d < DIFFICULTY_COUNT; d++) {
+    // a fixed set of generated puzzles, then time the checks alone
+    int count = ops < 256 ? (int)ops : 256;
+    PackedBoard *puzzles = malloc((size_t)count * sizeof(PackedBoard));
+    if (puzzles == NULL) {
+      fprintf(stderr, "Error: Failed to allocate memory\n");
+      exit(EXIT_FAILURE);
+    }
+    for (int k = 0; k < count; k++) {
+      PackedBoard solution;
+      generate_puzzle(&ctx, &puzzles[k], &solution, difficulty_cells_removed((Difficulty)d));
+    }
+    Samples samples;
+    samples_init(&samples, ops);
+    for (long k = 0; k < ops; k++) {
+      uint64_t start = time_now_ns();
+      has_unique_solution(&puzzles[k % count]);
+      samples_add(&samples, start);
+    }
+    samples_report(&samples, "has_unique_solution", difficulty_name((Difficulty)d));
+    free(puzzles);
+  }
+}
+
+// solve_batch() vs solve_board() in a loop over BATCH_BOARDS generated hard puzzles,
+// one op = the whole batch
+#define BATCH_BOARDS 256
+static void bench_batch(long ops, uint64_t seed) {
+  GeneratorContext ctx;
+  generator_init(&ctx, seed);
+  PackedBoard *puzzles = malloc(2 * BATCH_BOARDS * sizeof(PackedBoard));
+  if (puzzles == NULL) {
+    fprintf(stderr, "Error: Failed to allocate memory\n");
+    exit(EXIT_FAILURE);
+  }
+  PackedBoard *solved = puzzles + BATCH_BOARDS;
+  int solutions[BATCH_BOARDS];
+  for (int k = 0; k < BATCH_BOARDS; k++) {
+    generate_puzzle(&ctx, &puzzles[k], &solved[k], HARD_CELLS_REMOVED);
+  }
+
+  long batches = ops / BATCH_BOARDS > 0 ? ops / BATCH_BOARDS : 1;
+  for (int interleaved = 0; interleaved < 2; interleaved++) {
+    Samples samples;
+    samples_init(&samples, batches);
+    for (long b = 0; b < batches; b++) {
+      uint64_t start = time_now_ns();
+      if (interleaved) {
+        solve_batch(puzzles, BATCH_BOARDS, 2, solutions, solved);
+      } else {
+        for (int k = 0; k < BATCH_BOARDS; k++) {
+          solutions[k] = solve_board(&puzzles[k], 2, &solved[k]);
+        }
+      }
+      samples_add(&samples, start);
+    }
+    samples_report(&samples, "solve_batch", interleaved ? "interleaved" : "sequential");
+  }
+  free(puzzles);
+}
+
+// What generate_new_game() does when the pool is empty
+static void bench_generate(long ops, uint64_t seed) {
+  GeneratorContext ctx;
+  generator_init(&ctx, seed);
+  for (int d = 0; d < DIFFICULTY_COUNT; d++) {
+    Samples samples;
+    samples_init(&samples, ops);
+#if defined(SUDOKU_STATS)
+    samples.has_nodes = true;
+#endif
+    for (long k = 0; k < ops; k++) {
+      PackedBoard puzzle, solution;
+      uint64_t start = time_now_ns();
+      generate_puzzle(&ctx, &puzzle, &solution, difficulty_cells_removed((Difficulty)d));
+      samples_add(&samples, start);
+      samples.nodes += ctx.stats.nodes;
+    }
+    samples_report(&samples, "generate_puzzle", difficulty_name((Difficulty)d));
+  }
+
+  // rating-targeted, with the 50 ms budget a frontend request would get
+  for (int d = 0; d < DIFFICULTY_COUNT; d++) {
+    Samples samples;
+    samples_init(&samples, ops);
+    RatedTarget target = {(Difficulty)d, 50000000ull, 0};
+    for (long k = 0; k < ops; k++) {
+      PackedBoard puzzle, solution;
+      PuzzleRating rating;
+      uint64_t start = time_now_ns();
+      generate_rated(&ctx, &target, &puzzle, &solution, &rating);
+      samples_add(&samples, start);
+    }
+    samples_report(&samples, "generate_rated", difficulty_name((Difficulty)d));
+  }
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+    "usage: %s [options]\n"
+    "  -n OPS      operations per benchmark (default %d)\n"
+    "  -s SEED     generator seed (default %d)\n"
+    "  -b NAME     only run fill, count, unique, batch or generate\n",
+    prog, DEFAULT_OPS, DEFAULT_SEED);
+}
+
+int main(int argc, char **argv) {
+  long ops = DEFAULT_OPS;
+  uint64_t seed = DEFAULT_SEED;
+  const char *only = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+    if (strcmp(arg, "-n") == 0 && value) {
+      ops = strtol(value, NULL, 10);
+      i++;
+    } else if (strcmp(arg, "-s") == 0 && value) {
+      seed = strtoull(value, NULL, 10);
+      i++;
+    } else if (strcmp(arg, "-b") == 0 && value) {
+      only = value;
+      i++;
+    } else {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (ops < 1) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (only == NULL || strcmp(only, "fill") == 0) {
+    bench_fill(ops, seed);
+  }
+  if (only == NULL || strcmp(only, "count") == 0) {
+    bench_count(ops);
+  }
+  if (only == NULL || strcmp(only, "unique") == 0) {
+    bench_unique(ops, seed);
+  }
+  if (only == NULL || strcmp(only, "batch") == 0) {
+    bench_batch(ops, seed);
+  }
+  if (only == NULL || strcmp(only, "generate") == 0) {
+    bench_generate(ops, seed);
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,473 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h> // For the default seed, printed so the run can be repeated
+
+#include "platform_thread.h"
+#include "puzzle_corpus.h"
+#include "puzzle_text.h"
+#include "sudoku_core.h"
+#include "sudoku_geometry.h"
+
+// Headless puzzle generator: no window, no raylib, just fill_grid()/remove_cells()
+// Output is one puzzle per line, 81 chars row-major, '.' for empty cells
+// (size*size chars for --size, values above 9 written as 'A', 'B', ...),
+// or a puzzle_corpus.h file with --binary.
+// --verify FILE solves a puzzle file instead and writes "puzzle,status[,solution]" lines
+
+#define CHUNK_SIZE 256              // puzzles per work item handed to a thread
+#define LINE_SIZE (2 * GEOMETRY_MAX_CELLS + 2) // puzzle ',' solution '\n'
+#define VERIFY_LINE_SIZE (2 * CELL_COUNT + 16)  // puzzle ',' status ',' solution '\n'
+#define IO_BUFFER_SIZE (1 << 20)
+
+// Batch shared by all worker threads. Work is split into chunks of CHUNK_SIZE puzzles;
+// chunk k is generated from its own seed and chunks are written in order, so the
+// output only depends on the seed, never on the thread count
+typedef struct {
+  FILE *out;
+  bool with_solutions;
+  bool binary;               // CorpusRecords instead of text lines
+  unsigned int flags;        // CORPUS_* generator settings
+  int size;                  // board side, 9 unless --size
+  uint64_t seed;
+  long count;                // puzzles per difficulty
+  int first_difficulty;
+  long chunks_per_difficulty;
+  long total_chunks;
+
+  Mutex lock;
+  CondVar chunk_written;
+  long next_chunk;           // next chunk to hand out
+  long next_to_write;        // chunk whose turn it is to be written
+} Batch;
+
+// Writes the cells of a board, '.' for empty
+static char *format_cells(char *text, const uint8_t *cells, int count) {
+  for (int i = 0; i < count; i++) {
+    text[i] = cells[i] == 0 ? '.' : cells[i] <= 9 ? (char)('0' + cells[i]) : (char)('A' + cells[i] - 10);
+  }
+  return text + count;
+}
+
+static char *format_board(char *text, const PackedBoard *board) {
+  return format_cells(text, board->cells, CELL_COUNT);
+}
+
+// Seed of puzzle n of a difficulty: corpus_generate() with it gives that puzzle again,
+// whatever the thread count or chunking
+static uint64_t puzzle_seed(uint64_t seed, int difficulty, long n) {
+  return seed ^ ((((uint64_t)difficulty << 48) + (uint64_t)n + 1) * 0x9E3779B97F4A7C15ull);
+}
+
+static void batch_worker(void *arg) {
+  Batch *batch = (Batch *)arg;
+  char *text = malloc((size_t)CHUNK_SIZE * LINE_SIZE);
+  if (text == NULL) {
+    fprintf(stderr, "Error: Failed to allocate memory\n");
+    exit(EXIT_FAILURE);
+  }
+
+  for (;;) {
+    mutex_lock(&batch->lock);
+    long chunk = batch->next_chunk++;
+    mutex_unlock(&batch->lock);
+    if (chunk >= batch->total_chunks) {
+      break;
+    }
+
+    int d = batch->first_difficulty + (int)(chunk / batch->chunks_per_difficulty);
+    long start = (chunk % batch->chunks_per_difficulty) * CHUNK_SIZE;
+    long n = batch->count - start < CHUNK_SIZE ? batch->count - start : CHUNK_SIZE;
+
+    char *end = text;
+    for (long i = 0; i < n; i++) {
+      uint64_t seed = puzzle_seed(batch->seed, d, start + i);
+      if (batch->binary) {
+        PackedBoard puzzle, solution;
+        corpus_generate(seed, (Difficulty)d, batch->flags, &puzzle, &solution);
+        CorpusRecord record;
+        corpus_record_pack(&record, &puzzle, &solution, seed, (Difficulty)d, rate_puzzle(&puzzle).hardest, batch->flags);
+        memcpy(end, &record, sizeof(record));
+        end += sizeof(record);
+        continue;
+      }
+      if (batch->size == ROWS) {
+        PackedBoard puzzle, solution;
+        corpus_generate(seed, (Difficulty)d, batch->flags, &puzzle, &solution);
+        end = format_board(end, &puzzle);
+        if (batch->with_solutions) {
+          *end++ = ',';
+          end = format_board(end, &solution);
+        }
+      } else {
+        uint8_t puzzle[GEOMETRY_MAX_CELLS], solution[GEOMETRY_MAX_CELLS];
+        int cells = batch->size * batch->size;
+        Rng rng;
+        rng_seed(&rng, seed);
+        if (generate_puzzle_sized(batch->size, &rng, puzzle, solution, geometry_cells_removed(batch->size, (Difficulty)d)) < 0) {
+          fprintf(stderr, "Error: failed to generate a %dx%d board\n", batch->size, batch->size);
+          exit(EXIT_FAILURE);
+        }
+        end = format_cells(end, puzzle, cells);
+        if (batch->with_solutions) {
+          *end++ = ',';
+          end = format_cells(end, solution, cells);
+        }
+      }
+      *end++ = '\n';
+    }
+
+    // wait for our turn so chunks come out in order
+    mutex_lock(&batch->lock);
+    while (batch->next_to_write != chunk) {
+      cond_wait(&batch->chunk_written, &batch->lock);
+    }
+    fwrite(text, 1, (size_t)(end - text), batch->out);
+    batch->next_to_write++;
+    cond_broadcast(&batch->chunk_written);
+    mutex_unlock(&batch->lock);
+  }
+  free(text);
+}
+
+typedef enum {
+  VERIFY_UNIQUE = 0,
+  VERIFY_MULTIPLE,
+  VERIFY_NONE,       // clues fit together but have no solution
+  VERIFY_INVALID,    // not an 81-char puzzle, or clues that conflict
+  VERIFY_COUNT
+} VerifyStatus;
+
+static const char *verify_names[VERIFY_COUNT] = {"unique", "multiple", "none", "invalid"};
+
+// Streaming solve over a puzzle file: a worker reads a chunk of lines under the lock,
+// solves it with the lock released and writes it in input order like Batch chunks,
+// so memory stays at one chunk per thread whatever the input size
+typedef struct {
+  TextReader reader;
+  FILE *out;
+  bool with_solutions;
+  long totals[VERIFY_COUNT];
+
+  Mutex lock;
+  CondVar chunk_written;
+  long next_chunk;
+  long next_to_write;
+} Verify;
+
+typedef struct {
+  PackedBoard board;
+  char raw[PUZZLE_TEXT_LENGTH];  // input text, echoed for invalid lines
+  int raw_length;
+  bool parsed;
+  int slot;                      // index into the chunk's solve_batch() arrays, -1 = invalid
+} VerifyLine;
+
+// One chunk's worth of solve_batch() input and output
+typedef struct {
+  PackedBoard boards[CHUNK_SIZE];
+  PackedBoard solutions[CHUNK_SIZE];
+  int counts[CHUNK_SIZE];
+} VerifySolve;
+
+static void verify_worker(void *arg) {
+  Verify *verify = (Verify *)arg;
+  VerifyLine *lines = malloc((size_t)CHUNK_SIZE * sizeof(VerifyLine));
+  VerifySolve *solve = malloc(sizeof(VerifySolve));
+  char *text = malloc((size_t)CHUNK_SIZE * VERIFY_LINE_SIZE);
+  if (lines == NULL || solve == NULL || text == NULL) {
+    fprintf(stderr, "Error: Failed to allocate memory\n");
+    exit(EXIT_FAILURE);
+  }
+
+  for (;;) {
+    mutex_lock(&verify->lock);
+    long chunk = verify->next_chunk++;
+    int n = 0;
+    const char *line;
+    size_t length;
+    while (n < CHUNK_SIZE && (line = text_reader_line(&verify->reader, &length)) != NULL) {
+      if (length == 0) {
+        continue; // blank lines carry no puzzle
+      }
+      VerifyLine *entry = &lines[n++];
+      entry->parsed = puzzle_text_parse(line, length, &entry->board);
+      entry->raw_length = length < PUZZLE_TEXT_LENGTH ? (int)length : PUZZLE_TEXT_LENGTH;
+      memcpy(entry->raw, line, (size_t)entry->raw_length);
+    }
+    mutex_unlock(&verify->lock);
+    if (n == 0) {
+      break; // input done; later chunk numbers are never written
+    }
+
+    int solvable = 0;
+    for (int k = 0; k < n; k++) {
+      VerifyLine *entry = &lines[k];
+      entry->slot = entry->parsed && board_consistent(&entry->board) ? solvable++ : -1;
+      if (entry->slot >= 0) {
+        solve->boards[entry->slot] = entry->board;
+      }
+    }
+    solve_batch(solve->boards, solvable, 2, solve->counts, solve->solutions);
+
+    long totals[VERIFY_COUNT] = {0};
+    char *end = text;
+    for (int k = 0; k < n; k++) {
+      VerifyLine *entry = &lines[k];
+      VerifyStatus status = VERIFY_INVALID;
+      if (entry->slot >= 0) {
+        int solutions = solve->counts[entry->slot];
+        status = solutions == 1 ? VERIFY_UNIQUE : solutions == 0 ? VERIFY_NONE : VERIFY_MULTIPLE;
+      }
+      totals[status]++;
+      if (entry->parsed) {
+        end = format_board(end, &entry->board);
+      } else {
+        memcpy(end, entry->raw, (size_t)entry->raw_length);
+        end += entry->raw_length;
+      }
+      end += sprintf(end, ",%s", verify_names[status]);
+      if (verify->with_solutions && status == VERIFY_UNIQUE) {
+        *end++ = ',';
+        end = format_board(end, &solve->solutions[entry->slot]);
+      }
+      *end++ = '\n';
+    }
+
+    mutex_lock(&verify->lock);
+    while (verify->next_to_write != chunk) {
+      cond_wait(&verify->chunk_written, &verify->lock);
+    }
+    fwrite(text, 1, (size_t)(end - text), verify->out);
+    for (int s = 0; s < VERIFY_COUNT; s++) {
+      verify->totals[s] += totals[s];
+    }
+    verify->next_to_write++;
+    cond_broadcast(&verify->chunk_written);
+    mutex_unlock(&verify->lock);
+  }
+  free(text);
+  free(solve);
+  free(lines);
+}
+
+// Runs fn on the calling thread plus threads - 1 more, returns once all are done
+static void run_workers(ThreadFn fn, void *arg, int threads) {
+  Thread *workers = calloc((size_t)threads, sizeof(Thread));
+  if (workers == NULL) {
+    fprintf(stderr, "Error: Failed to allocate memory\n");
+    exit(EXIT_FAILURE);
+  }
+  int started = 0;
+  for (int t = 1; t < threads; t++) {
+    if (thread_start(&workers[t], fn, arg)) {
+      started = t;
+    } else {
+      break; // keep going with the threads we have
+    }
+  }
+  fn(arg); // the main thread works too
+  for (int t = 1; t <= started; t++) {
+    thread_join(&workers[t]);
+  }
+  free(workers);
+}
+
+static bool run_verify(const char *in_path, FILE *out, bool with_solutions, int threads) {
+  FILE *in = strcmp(in_path, "-") == 0 ? stdin : fopen(in_path, "rb");
+  if (in == NULL) {
+    fprintf(stderr, "Error: cannot open '%s'\n", in_path);
+    return false;
+  }
+  static char in_buffer[IO_BUFFER_SIZE];
+  static Verify verify; // zeroed, holds no buffers itself
+  text_reader_init(&verify.reader, in, in_buffer, sizeof(in_buffer));
+  verify.out = out;
+  verify.with_solutions = with_solutions;
+  mutex_init(&verify.lock);
+  cond_init(&verify.chunk_written);
+
+  run_workers(verify_worker, &verify, threads);
+  cond_destroy(&verify.chunk_written);
+  mutex_destroy(&verify.lock);
+
+  bool ok = !ferror(in);
+  if (in != stdin) {
+    fclose(in);
+  }
+  long total = 0;
+  for (int s = 0; s < VERIFY_COUNT; s++) {
+    total += verify.totals[s];
+  }
+  fprintf(stderr, "%ld puzzles:", total);
+  for (int s = 0; s < VERIFY_COUNT; s++) {
+    fprintf(stderr, " %ld %s", verify.totals[s], verify_names[s]);
+  }
+  fprintf(stderr, "\n");
+  if (!ok) {
+    fprintf(stderr, "Error: failed reading '%s'\n", in_path);
+  }
+  return ok;
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+    "usage: %s [options]\n"
+    "  -n COUNT       puzzles per difficulty (default 1)\n"
+    "  -d DIFFICULTY  easy, medium, hard or all (default all)\n"
+    "  -s SEED        generator seed (default: time)\n"
+    "  -j THREADS     worker threads (default: one per CPU)\n"
+    "  -o FILE        write to FILE instead of stdout\n"
+    "  --solutions    append ',' and the solution to every line\n"
+    "  --binary       write a binary corpus (puzzle_corpus.h) instead of text\n"
+    "  --rated        pick puzzles by technique rating instead of clue count (9x9 only)\n"
+    "  --symmetric    remove cells in rotationally symmetric pairs\n"
+    "  --fill MODE    backtrack (uniform, default) or transform (no search)\n"
+    "  --size N       board side: 4, 9, 16 or 25 (default 9)\n"
+    "  --verify FILE  solve every puzzle in FILE ('-' = stdin) instead of generating\n",
+    prog);
+}
+
+int main(int argc, char **argv) {
+  long count = 1;
+  int difficulty = -1; // -1 = all
+  uint64_t seed = 0;
+  bool seeded = false;
+  int threads = cpu_count();
+  const char *out_path = NULL;
+  bool with_solutions = false;
+  bool binary = false;
+  bool rated = false;
+  const char *verify_path = NULL;
+  bool symmetric = false;
+  FillStrategy fill = FILL_BACKTRACK;
+  int size = ROWS;
+
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+    if (strcmp(arg, "-n") == 0 && value) {
+      count = strtol(value, NULL, 10);
+      i++;
+    } else if (strcmp(arg, "-d") == 0 && value) {
+      difficulty = -2;
+      for (int d = 0; d < DIFFICULTY_COUNT; d++) {
+        if (strcmp(value, difficulty_name((Difficulty)d)) == 0) {
+          difficulty = d;
+        }
+      }
+      if (strcmp(value, "all") == 0) {
+        difficulty = -1;
+      }
+      if (difficulty == -2) {
+        fprintf(stderr, "Error: unknown difficulty '%s'\n", value);
+        return EXIT_FAILURE;
+      }
+      i++;
+    } else if (strcmp(arg, "-s") == 0 && value) {
+      seed = strtoull(value, NULL, 10);
+      seeded = true;
+      i++;
+    } else if (strcmp(arg, "-j") == 0 && value) {
+      threads = atoi(value);
+      i++;
+    } else if (strcmp(arg, "-o") == 0 && value) {
+      out_path = value;
+      i++;
+    } else if (strcmp(arg, "--solutions") == 0) {
+      with_solutions = true;
+    } else if (strcmp(arg, "--binary") == 0) {
+      binary = true;
+    } else if (strcmp(arg, "--rated") == 0) {
+      rated = true;
+    } else if (strcmp(arg, "--symmetric") == 0) {
+      symmetric = true;
+    } else if (strcmp(arg, "--fill") == 0 && value) {
+      if (strcmp(value, "backtrack") == 0) {
+        fill = FILL_BACKTRACK;
+      } else if (strcmp(value, "transform") == 0) {
+        fill = FILL_TRANSFORM;
+      } else {
+        fprintf(stderr, "Error: unknown fill '%s'\n", value);
+        return EXIT_FAILURE;
+      }
+      i++;
+    } else if (strcmp(arg, "--verify") == 0 && value) {
+      verify_path = value;
+      i++;
+    } else if (strcmp(arg, "--size") == 0 && value) {
+      size = atoi(value);
+      if (!geometry_supported(size)) {
+        fprintf(stderr, "Error: unsupported board size '%s'\n", value);
+        return EXIT_FAILURE;
+      }
+      i++;
+    } else {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (count < 0 || threads < 1) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (!seeded && verify_path == NULL) {
+    seed = (uint64_t)time(0);
+    fprintf(stderr, "seed %llu\n", (unsigned long long)seed);
+  }
+  if ((binary || rated) && size != ROWS) {
+    fprintf(stderr, "Error: --binary and --rated only support 9x9 boards\n");
+    return EXIT_FAILURE;
+  }
+
+  FILE *out = stdout;
+  if (out_path != NULL) {
+    out = fopen(out_path, "wb");
+    if (out == NULL) {
+      fprintf(stderr, "Error: cannot open '%s'\n", out_path);
+      return EXIT_FAILURE;
+    }
+  }
+  static char out_buffer[IO_BUFFER_SIZE]; // big writes, lines are tiny
+  setvbuf(out, out_buffer, _IOFBF, sizeof(out_buffer));
+  bool ok = true;
+  if (verify_path != NULL) {
+    ok = run_verify(verify_path, out, with_solutions, threads);
+  } else {
+    if (binary) {
+      uint64_t counts[DIFFICULTY_COUNT] = {0};
+      for (int d = 0; d < DIFFICULTY_COUNT; d++) {
+        counts[d] = difficulty < 0 || difficulty == d ? (uint64_t)count : 0;
+      }
+      CorpusHeader header;
+      corpus_header_init(&header, counts);
+      fwrite(&header, sizeof(header), 1, out);
+    }
+
+    Batch batch = {0};
+    batch.out = out;
+    batch.with_solutions = with_solutions;
+    batch.binary = binary;
+    batch.flags = (symmetric ? CORPUS_SYMMETRIC : 0) | (fill == FILL_TRANSFORM ? CORPUS_TRANSFORM : 0) | (rated ? CORPUS_RATED : 0);
+    batch.size = size;
+    batch.seed = seed;
+    batch.count = count;
+    batch.first_difficulty = difficulty >= 0 ? difficulty : 0;
+    batch.chunks_per_difficulty = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    batch.total_chunks = batch.chunks_per_difficulty * (difficulty >= 0 ? 1 : DIFFICULTY_COUNT);
+    mutex_init(&batch.lock);
+    cond_init(&batch.chunk_written);
+    if (threads > batch.total_chunks) {
+      threads = batch.total_chunks > 0 ? (int)batch.total_chunks : 1;
+    }
+    run_workers(batch_worker, &batch, threads);
+    cond_destroy(&batch.chunk_written);
+    mutex_destroy(&batch.lock);
+  }
+
+  if (fflush(out) != 0 || (out != stdout && fclose(out) != 0)) {
+    fprintf(stderr, "Error: failed writing output\n");
+    return EXIT_FAILURE;
+  }
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
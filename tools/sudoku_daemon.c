@@ -0,0 +1,539 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L // sockets under -std=c17
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h> // For the default seed
+
+#include "platform_thread.h"
+#include "puzzle_corpus.h"
+#include "puzzle_pool.h"
+#include "puzzle_service.h"
+#include "sudoku_core.h"
+
+// Puzzle service: keeps a PuzzlePool warm and answers batched SERVICE_GENERATE /
+// SERVICE_VERIFY requests (puzzle_service.h) over TCP. The main thread polls the listener
+// and every connection and reads requests as their bytes arrive; each complete request
+// goes into a shared job queue that the worker threads drain. Idle clients cost a pollfd,
+// not a thread. A connection is not read further while its request is with a worker, so
+// replies keep the request order. Generate requests are popped from the pool, the worker
+// generates inline once the pool runs dry or for settings the pool does not keep.
+
+#if defined(_WIN32)
+
+#if !defined(_WIN32_WINNT) || _WIN32_WINNT < 0x0600
+#undef _WIN32_WINNT
+#define _WIN32_WINNT 0x0600 // WSAPoll()
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#include <ws2tcpip.h>
+
+typedef SOCKET Socket;
+#define SOCKET_NONE INVALID_SOCKET
+#define socket_close closesocket
+#define poll WSAPoll
+
+static bool socket_startup(void) {
+  WSADATA data;
+  return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+}
+
+static void socket_set_send_timeout(Socket s, int ms) {
+  DWORD timeout = (DWORD)ms;
+  setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, (const char *)&timeout, sizeof(timeout));
+}
+
+#else
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+typedef int Socket;
+#define SOCKET_NONE (-1)
+#define socket_close close
+
+static bool socket_startup(void) {
+  signal(SIGPIPE, SIG_IGN); // a client going away is a failed send, not a dead daemon
+  return true;
+}
+
+static void socket_set_send_timeout(Socket s, int ms) {
+  struct timeval timeout = {ms / 1000, (ms % 1000) * 1000};
+  setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, (const char *)&timeout, sizeof(timeout));
+}
+
+#endif
+
+#define DAEMON_MAX_CONNECTIONS 1024 // the listener is not polled while this many are open
+#define DAEMON_SEND_TIMEOUT_MS 5000 // a client that stops reading replies loses its connection, not a worker
+
+// One client. Only the main thread touches it while it reads, only one worker while
+// busy; the hand-over goes through the daemon's lists under its lock
+typedef struct Connection {
+  Socket socket;
+  ServiceHeader request;
+  size_t received;          // bytes of the request (header, then payload) read so far
+  uint8_t *payload;         // SERVICE_VERIFY boards
+  size_t payload_size;      // of the current request
+  size_t payload_capacity;
+  uint8_t status;           // ServiceStatus found while reading the header
+  bool busy;                // queued or with a worker: not polled
+  bool close;               // set by the worker, dropped once handed back
+  struct Connection *next;  // job or done list
+} Connection;
+
+typedef struct {
+  PuzzlePool pool;
+  Mutex lock;
+  CondVar queued;           // a job is waiting
+  Connection *jobs;         // complete requests, oldest first
+  Connection *jobs_tail;
+  Connection *done;         // answered, waiting for the main thread to poll them again
+  Socket wake;              // loopback UDP socket, a datagram wakes the main thread's poll()
+} Daemon;
+
+// Reply buffers are sized for SERVICE_MAX_COUNT records once, at start
+typedef struct {
+  Daemon *daemon;
+  Thread thread;
+  GeneratorContext ctx; // seeds for puzzles the pool cannot serve
+  uint8_t *reply;       // header + records
+  PackedBoard *boards;
+  PackedBoard *solutions;
+  int *counts;
+  int *slots;           // board -> solve_batch() slot, -1 = invalid
+} Worker;
+
+static bool send_all(Socket s, const void *data, size_t size) {
+  const char *p = (const char *)data;
+  while (size > 0) {
+    int sent = (int)send(s, p, (int)size, 0);
+    if (sent <= 0) {
+      return false;
+    }
+    p += sent;
+    size -= (size_t)sent;
+  }
+  return true;
+}
+
+// Fills reply with count CorpusRecords; returns the reply payload size
+static size_t serve_generate(Worker *worker, const ServiceHeader *request) {
+  Difficulty difficulty = (Difficulty)request->difficulty;
+  CorpusRecord *records = (CorpusRecord *)(worker->reply + sizeof(ServiceHeader));
+  for (uint32_t n = 0; n < request->count; n++) {
+    PoolEntry entry;
+    if (request->flags != 0 || !pool_pop(&worker->daemon->pool, difficulty, &entry)) {
+      entry.seed = rng_next64(&worker->ctx.rng);
+      entry.flags = request->flags;
+      corpus_generate(entry.seed, difficulty, entry.flags, &entry.puzzle, &entry.solution);
+    }
+    PuzzleRating rating = rate_puzzle(&entry.puzzle);
+    corpus_record_pack(&records[n], &entry.puzzle, &entry.solution, entry.seed, difficulty, rating.hardest, entry.flags);
+  }
+  return (size_t)request->count * sizeof(CorpusRecord);
+}
+
+// Solves the boards of the payload with one solve_batch() call; returns the reply payload size
+static size_t serve_verify(Worker *worker, const ServiceHeader *request, const uint8_t *input) {
+  int count = (int)request->count;
+  int solvable = 0;
+  for (int n = 0; n < count; n++) {
+    const uint8_t *cells = input + (size_t)n * CELL_COUNT;
+    PackedBoard board;
+    memset(&board, 0, sizeof(board));
+    bool parsed = true;
+    for (int i = 0; i < CELL_COUNT; i++) {
+      parsed &= cells[i] <= V_9;
+      board.cells[i] = cells[i];
+      board_set_fixed(&board, i, cells[i] != V_None);
+    }
+    worker->slots[n] = parsed && board_consistent(&board) ? solvable++ : -1;
+    if (worker->slots[n] >= 0) {
+      worker->boards[worker->slots[n]] = board;
+    }
+  }
+  solve_batch(worker->boards, solvable, 2, worker->counts, worker->solutions);
+
+  ServiceVerifyRecord *records = (ServiceVerifyRecord *)(worker->reply + sizeof(ServiceHeader));
+  for (int n = 0; n < count; n++) {
+    ServiceVerifyRecord *record = &records[n];
+    memset(record, 0, sizeof(*record));
+    record->status = SERVICE_INVALID;
+    int slot = worker->slots[n];
+    if (slot < 0) {
+      continue;
+    }
+    const PackedBoard *board = &worker->boards[slot];
+    int solutions = worker->counts[slot];
+    record->status = solutions == 1 ? SERVICE_UNIQUE : solutions == 0 ? SERVICE_NONE : SERVICE_MULTIPLE;
+    for (int i = 0; i < CELL_COUNT; i++) {
+      record->clue_count += board->cells[i] != V_None;
+    }
+    if (record->status == SERVICE_UNIQUE) {
+      PuzzleRating rating = rate_puzzle(board);
+      record->hardest = (uint8_t)rating.hardest;
+      record->difficulty = (uint8_t)rating_difficulty(&rating);
+      for (int i = 0; i < CELL_COUNT; i++) {
+        record->solution[i >> 1] |= (uint8_t)(worker->solutions[slot].cells[i] << ((i & 1) * 4));
+      }
+    }
+  }
+  return (size_t)count * sizeof(ServiceVerifyRecord);
+}
+
+// Answers the connection's request; false if the connection has to be closed
+static bool serve_request(Worker *worker, Connection *connection) {
+  const ServiceHeader *request = &connection->request;
+  ServiceHeader reply = *request;
+  reply.flags = connection->status;
+  reply.count = 0;
+  size_t payload = 0;
+  if (reply.flags != SERVICE_OK) {
+    // found while reading the header
+  } else if (request->type == SERVICE_GENERATE) {
+    if (request->difficulty >= DIFFICULTY_COUNT || (request->flags & ~CORPUS_FLAGS) != 0) {
+      reply.flags = SERVICE_BAD_REQUEST;
+    } else {
+      payload = serve_generate(worker, request);
+    }
+  } else if (request->type == SERVICE_VERIFY) {
+    payload = serve_verify(worker, request, connection->payload);
+  } else {
+    reply.flags = SERVICE_BAD_REQUEST;
+  }
+
+  if (reply.flags == SERVICE_OK) {
+    reply.count = request->count;
+  }
+  memcpy(worker->reply, &reply, sizeof(reply));
+  // after an error the rest of the stream cannot be resynchronized
+  return send_all(connection->socket, worker->reply, sizeof(reply) + payload) && reply.flags == SERVICE_OK;
+}
+
+static void worker_main(void *arg) {
+  Worker *worker = (Worker *)arg;
+  Daemon *daemon = worker->daemon;
+  for (;;) {
+    mutex_lock(&daemon->lock);
+    while (daemon->jobs == NULL) {
+      cond_wait(&daemon->queued, &daemon->lock);
+    }
+    Connection *connection = daemon->jobs;
+    daemon->jobs = connection->next;
+    mutex_unlock(&daemon->lock);
+
+    connection->close = !serve_request(worker, connection);
+    connection->received = 0;
+
+    mutex_lock(&daemon->lock);
+    connection->next = daemon->done;
+    daemon->done = connection;
+    mutex_unlock(&daemon->lock);
+    char poke = 0;
+    send(daemon->wake, &poke, 1, 0);
+  }
+}
+
+static bool worker_init(Worker *worker, Daemon *daemon, uint64_t seed) {
+  size_t record_size = sizeof(CorpusRecord) > sizeof(ServiceVerifyRecord) ? sizeof(CorpusRecord) : sizeof(ServiceVerifyRecord);
+  worker->daemon = daemon;
+  generator_init(&worker->ctx, seed);
+  worker->reply = malloc(sizeof(ServiceHeader) + SERVICE_MAX_COUNT * record_size);
+  worker->boards = malloc(SERVICE_MAX_COUNT * sizeof(PackedBoard));
+  worker->solutions = malloc(SERVICE_MAX_COUNT * sizeof(PackedBoard));
+  worker->counts = malloc(SERVICE_MAX_COUNT * sizeof(int));
+  worker->slots = malloc(SERVICE_MAX_COUNT * sizeof(int));
+  return worker->reply != NULL && worker->boards != NULL && worker->solutions != NULL &&
+         worker->counts != NULL && worker->slots != NULL;
+}
+
+static void daemon_queue(Daemon *daemon, Connection *connection) {
+  connection->busy = true;
+  connection->next = NULL;
+  mutex_lock(&daemon->lock);
+  if (daemon->jobs == NULL) {
+    daemon->jobs = connection;
+  } else {
+    daemon->jobs_tail->next = connection;
+  }
+  daemon->jobs_tail = connection;
+  cond_signal(&daemon->queued);
+  mutex_unlock(&daemon->lock);
+}
+
+// Checks a complete header and sizes the payload buffer for it
+static void connection_header_done(Connection *connection) {
+  const ServiceHeader *request = &connection->request;
+  connection->status = SERVICE_OK;
+  connection->payload_size = 0;
+  if (memcmp(request->magic, SERVICE_MAGIC, 4) != 0 || request->version != SERVICE_VERSION) {
+    connection->status = SERVICE_BAD_REQUEST;
+  } else if (request->count > SERVICE_MAX_COUNT) {
+    connection->status = SERVICE_TOO_LARGE;
+  } else if (request->type == SERVICE_VERIFY) {
+    size_t size = (size_t)request->count * CELL_COUNT;
+    if (size > connection->payload_capacity) {
+      uint8_t *payload = realloc(connection->payload, size);
+      if (payload == NULL) {
+        connection->status = SERVICE_FAILED;
+        return;
+      }
+      connection->payload = payload;
+      connection->payload_capacity = size;
+    }
+    connection->payload_size = size;
+  }
+}
+
+// Reads what has arrived: -1 = closed or failed, 0 = request incomplete, 1 = request complete
+static int connection_read(Connection *connection) {
+  size_t header_size = sizeof(ServiceHeader);
+  char *target;
+  size_t want;
+  if (connection->received < header_size) {
+    target = (char *)&connection->request + connection->received;
+    want = header_size - connection->received;
+  } else {
+    target = (char *)connection->payload + (connection->received - header_size);
+    want = header_size + connection->payload_size - connection->received;
+  }
+  int got = (int)recv(connection->socket, target, (int)want, 0);
+  if (got <= 0) {
+    return -1;
+  }
+  connection->received += (size_t)got;
+  if (connection->received == header_size) {
+    connection_header_done(connection);
+  }
+  return connection->received >= header_size && connection->received == header_size + connection->payload_size;
+}
+
+static void connection_free(Connection *connection) {
+  socket_close(connection->socket);
+  free(connection->payload);
+  free(connection);
+}
+
+// Closes a connection and removes it from the open list (order does not matter)
+static void connection_drop(Connection **connections, int *open, Connection *connection) {
+  for (int c = 0; c < *open; c++) {
+    if (connections[c] == connection) {
+      connections[c] = connections[--*open];
+      break;
+    }
+  }
+  connection_free(connection);
+}
+
+static Socket open_listener(const char *address, int port) {
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons((unsigned short)port);
+  if (inet_pton(AF_INET, address, &addr.sin_addr) != 1) {
+    return SOCKET_NONE;
+  }
+  Socket s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (s == SOCKET_NONE) {
+    return SOCKET_NONE;
+  }
+  int on = 1;
+  setsockopt(s, SOL_SOCKET, SO_REUSEADDR, (const char *)&on, sizeof(on));
+  if (bind(s, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(s, SOMAXCONN) != 0) {
+    socket_close(s);
+    return SOCKET_NONE;
+  }
+  return s;
+}
+
+// UDP socket connected to itself: works with poll() on every platform, unlike a pipe
+static Socket open_wake_socket(void) {
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  Socket s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if (s == SOCKET_NONE) {
+    return SOCKET_NONE;
+  }
+  socklen_t size = sizeof(addr);
+  if (bind(s, (struct sockaddr *)&addr, sizeof(addr)) != 0 || getsockname(s, (struct sockaddr *)&addr, &size) != 0 ||
+      connect(s, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+    socket_close(s);
+    return SOCKET_NONE;
+  }
+  return s;
+}
+
+// Takes back the connections the workers are done with
+static void daemon_collect(Daemon *daemon, Connection **connections, int *open) {
+  char poke;
+  recv(daemon->wake, &poke, 1, 0); // one datagram per poll; leftovers just wake it again
+  mutex_lock(&daemon->lock);
+  Connection *done = daemon->done;
+  daemon->done = NULL;
+  mutex_unlock(&daemon->lock);
+  while (done != NULL) {
+    Connection *connection = done;
+    done = done->next;
+    connection->busy = false;
+    if (connection->close) {
+      connection_drop(connections, open, connection);
+    }
+  }
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+    "usage: %s [options]\n"
+    "  -p PORT        TCP port (default %d)\n"
+    "  -b ADDRESS     IPv4 address to listen on (default 127.0.0.1)\n"
+    "  -j THREADS     worker threads (default: one per CPU)\n"
+    "  -c FILE        serve puzzles from a corpus (sudoku-cli --binary) before generating\n"
+    "  -s SEED        generator seed (default: time)\n",
+    prog, SERVICE_DEFAULT_PORT);
+}
+
+int main(int argc, char **argv) {
+  int port = SERVICE_DEFAULT_PORT;
+  const char *address = "127.0.0.1";
+  int threads = cpu_count();
+  const char *corpus_path = NULL;
+  uint64_t seed = (uint64_t)time(0);
+
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+    if (strcmp(arg, "-p") == 0 && value) {
+      port = atoi(value);
+      i++;
+    } else if (strcmp(arg, "-b") == 0 && value) {
+      address = value;
+      i++;
+    } else if (strcmp(arg, "-j") == 0 && value) {
+      threads = atoi(value);
+      i++;
+    } else if (strcmp(arg, "-c") == 0 && value) {
+      corpus_path = value;
+      i++;
+    } else if (strcmp(arg, "-s") == 0 && value) {
+      seed = strtoull(value, NULL, 10);
+      i++;
+    } else {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (threads < 1 || port <= 0 || port > 65535) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (!socket_startup()) {
+    fprintf(stderr, "Error: socket startup failed\n");
+    return EXIT_FAILURE;
+  }
+  Socket listener = open_listener(address, port);
+  if (listener == SOCKET_NONE) {
+    fprintf(stderr, "Error: cannot listen on %s:%d\n", address, port);
+    return EXIT_FAILURE;
+  }
+
+  static Daemon daemon;
+  static PuzzleCorpus corpus;
+  daemon.wake = open_wake_socket();
+  if (daemon.wake == SOCKET_NONE) {
+    fprintf(stderr, "Error: cannot open the wake-up socket\n");
+    return EXIT_FAILURE;
+  }
+  pool_init(&daemon.pool, seed);
+  if (corpus_path != NULL) {
+    if (!corpus_open(&corpus, corpus_path)) {
+      fprintf(stderr, "Error: cannot open corpus '%s'\n", corpus_path);
+      return EXIT_FAILURE;
+    }
+    pool_attach_corpus(&daemon.pool, &corpus);
+  }
+  pool_start(&daemon.pool);
+  mutex_init(&daemon.lock);
+  cond_init(&daemon.queued);
+
+  Worker *workers = calloc((size_t)threads, sizeof(Worker));
+  Connection **connections = calloc(DAEMON_MAX_CONNECTIONS, sizeof(Connection *));
+  struct pollfd *fds = calloc(DAEMON_MAX_CONNECTIONS + 2, sizeof(struct pollfd));
+  Connection **polled = calloc(DAEMON_MAX_CONNECTIONS + 2, sizeof(Connection *)); // fds[n] -> connection
+  if (workers == NULL || connections == NULL || fds == NULL || polled == NULL) {
+    fprintf(stderr, "Error: Failed to allocate memory\n");
+    return EXIT_FAILURE;
+  }
+  for (int t = 0; t < threads; t++) {
+    // same mixing as sudoku-cli's puzzle seeds, so workers never share a sequence
+    uint64_t worker_seed = seed ^ (((uint64_t)t + 1) * 0x9E3779B97F4A7C15ull);
+    if (!worker_init(&workers[t], &daemon, worker_seed) || !thread_start(&workers[t].thread, worker_main, &workers[t])) {
+      fprintf(stderr, "Error: cannot start worker %d\n", t);
+      return EXIT_FAILURE;
+    }
+  }
+  fprintf(stderr, "listening on %s:%d, %d workers\n", address, port, threads);
+
+  // runs until killed: nothing is kept that would need saving
+  int open = 0;
+  for (;;) {
+    int count = 0;
+    fds[count++] = (struct pollfd){.fd = daemon.wake, .events = POLLIN};
+    int listening = open < DAEMON_MAX_CONNECTIONS;
+    if (listening) {
+      fds[count++] = (struct pollfd){.fd = listener, .events = POLLIN};
+    }
+    for (int c = 0; c < open; c++) {
+      if (!connections[c]->busy) {
+        polled[count] = connections[c];
+        fds[count++] = (struct pollfd){.fd = connections[c]->socket, .events = POLLIN};
+      }
+    }
+    if (poll(fds, (unsigned int)count, -1) <= 0) {
+      continue;
+    }
+
+    for (int n = 1 + listening; n < count; n++) {
+      if (fds[n].revents == 0) {
+        continue;
+      }
+      Connection *connection = polled[n];
+      int state = (fds[n].revents & POLLNVAL) ? -1 : connection_read(connection);
+      if (state > 0) {
+        daemon_queue(&daemon, connection);
+      } else if (state < 0) {
+        connection_drop(connections, &open, connection);
+      }
+    }
+    if (fds[0].revents & POLLIN) {
+      daemon_collect(&daemon, connections, &open);
+    }
+    if (listening && (fds[1].revents & POLLIN)) {
+      Socket client = accept(listener, NULL, NULL);
+      Connection *connection = client != SOCKET_NONE ? calloc(1, sizeof(Connection)) : NULL;
+      if (connection == NULL) {
+        if (client != SOCKET_NONE) {
+          socket_close(client);
+        }
+        continue;
+      }
+      int on = 1;
+      setsockopt(client, IPPROTO_TCP, TCP_NODELAY, (const char *)&on, sizeof(on));
+      socket_set_send_timeout(client, DAEMON_SEND_TIMEOUT_MS);
+      connection->socket = client;
+      connections[open++] = connection;
+    }
+  }
+}